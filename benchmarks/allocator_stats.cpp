@@ -0,0 +1,206 @@
+#include <ds/all>
+#include <ds/thread>
+#include <ds/allocator_stats>
+#include <ds/benchmark>
+
+// json-shaped documents built and freed by 1-8 threads, strings, object keys,
+// array elements and object members each allocated under a tag of their own.
+// DefaultAllocator as is, behind a disabled ds::TracingAllocator, behind an
+// enabled one, and behind one that also samples every 1000th call stack. The
+// statistics of the sampled run are printed at the end. An iteration builds
+// every document once on fresh threads, a few samples of one each are taken.
+
+static constexpr size_t samples    = 3;
+static constexpr size_t total_docs = 1 << 11;
+static constexpr size_t doc_nodes  = 512;
+static constexpr size_t thread_max = 8;
+
+struct Strings {};
+struct Keys {};
+struct Elements {};
+struct Members {};
+template <class Tag> struct Sampled {};
+
+template <class Tag> using Raw     = ds::DefaultAllocator;
+template <class Tag> using Off     = ds::TracingAllocator<ds::DefaultAllocator,Tag,false>;
+template <class Tag> using On      = ds::TracingAllocator<ds::DefaultAllocator,Tag,true>;
+template <class Tag> using Sampler = ds::TracingAllocator<ds::DefaultAllocator,Sampled<Tag>,true>;
+
+enum class Kind : uint8_t { integer, string, array, object };
+
+struct Node
+{
+	Kind     kind;
+	uint32_t count;
+	union
+	{
+		int64_t  integer;
+		char   * string;
+		Node   * children;
+	};
+	char ** keys;
+};
+
+template <class A>
+static char *
+make_string(uint64_t & state_)
+{
+	auto const size_ = 4 + ds::xorshift(state_) % 40;
+	auto     * text_ = static_cast<char *>(A::allocate(size_ + 1, 1));
+	for(size_t i = 0; i < size_; ++i)
+		text_[i] = char('a' + ds::xorshift(state_) % 26);
+	text_[size_] = '\0';
+	return text_;
+}
+
+template <template <class> class A>
+static void
+build(Node & node_, uint64_t & state_, size_t & budget_)
+{
+	auto const roll_ = ds::xorshift(state_) % 8;
+	node_.keys = nullptr;
+	if(budget_ < 4 || roll_ < 3)
+	{
+		node_.kind    = Kind::integer;
+		node_.count   = 0;
+		node_.integer = int64_t(ds::xorshift(state_));
+	}
+	else if(roll_ < 5)
+	{
+		node_.kind   = Kind::string;
+		node_.count  = 0;
+		node_.string = make_string<A<Strings>>(state_);
+	}
+	else
+	{
+		auto const count_ = uint32_t(1 + ds::xorshift(state_) % (budget_ < 12 ? budget_ : 12));
+		budget_ -= count_;
+		node_.kind  = roll_ < 6 ? Kind::array : Kind::object;
+		node_.count = count_;
+		if(node_.kind == Kind::array)
+			node_.children = static_cast<Node *>(A<Elements>::allocate(count_ * sizeof(Node), alignof(Node)));
+		else
+		{
+			node_.children = static_cast<Node *>(A<Members>::allocate(count_ * sizeof(Node), alignof(Node)));
+			node_.keys     = static_cast<char **>(A<Keys>::allocate(count_ * sizeof(char *), alignof(char *)));
+		}
+		for(uint32_t i = 0; i < count_; ++i)
+		{
+			if(node_.keys)
+				node_.keys[i] = make_string<A<Keys>>(state_);
+			build<A>(node_.children[i], state_, budget_);
+		}
+	}
+}
+
+// checksum of the document, freeing it on the way
+template <template <class> class A>
+static uint64_t
+destroy(Node & node_)
+{
+	uint64_t sum_ = 0;
+	switch(node_.kind)
+	{
+		case Kind::integer:
+			sum_ = uint64_t(node_.integer);
+			break;
+		case Kind::string:
+			sum_ = uint64_t(node_.string[0]);
+			A<Strings>::deallocate(node_.string);
+			break;
+		default:
+			for(uint32_t i = 0; i < node_.count; ++i)
+			{
+				if(node_.keys)
+				{
+					sum_ += uint64_t(node_.keys[i][0]);
+					A<Keys>::deallocate(node_.keys[i]);
+				}
+				sum_ += destroy<A>(node_.children[i]);
+			}
+			if(node_.keys)
+			{
+				A<Keys>::deallocate(node_.keys);
+				A<Members>::deallocate(node_.children);
+			}
+			else
+				A<Elements>::deallocate(node_.children);
+	}
+	return sum_;
+}
+
+template <template <class> class A>
+static uint64_t
+document(uint64_t seed_)
+{
+	Node   root_;
+	size_t budget_ = doc_nodes;
+	while(budget_ >= 4)
+	{
+		build<A>(root_, seed_, budget_);
+		if(root_.kind != Kind::integer)
+			break;
+	}
+	return destroy<A>(root_);
+}
+
+template <template <class> class A>
+static void
+run(ds::Benchmark & suite_, char const * name_, size_t threads_)
+{
+	std::atomic<uint64_t> sum_ { 0 };
+	char                  label_[64];
+	snprintf(label_, sizeof(label_), "%-9s %zu threads", name_, threads_);
+	suite_.run(label_, [&]()
+	{
+		size_t index_   = 0;
+		auto   workers_ = ds::Stack<ds::Thread>(threads_, [&]()
+		{
+			auto i = index_++;
+			return ds::Thread({ 0, "ds_builder" }, [&, i](ds::Persistent<ds::Thread *>)
+			{
+				uint64_t local_ = 0;
+				for(size_t n = i; n < total_docs; n += threads_)
+					local_ += document<A>(0x9e3779b97f4a7c15ULL + n);
+				sum_.fetch_add(local_, std::memory_order_relaxed);
+			});
+		});
+		for(auto & thread_ : workers_)
+			thread_.join();
+	}, { 0, double(total_docs * doc_nodes) });
+	printf("  checksum %llu\n", (unsigned long long)sum_.load());
+}
+
+struct StdOut
+{
+	size_t
+	write(void const * data_, size_t size_, size_t count_)
+	{
+		return fwrite(data_, size_, count_, stdout);
+	}
+};
+
+int main()
+{
+	Sampler<Strings>::name("strings");
+	Sampler<Keys>::name("keys");
+	Sampler<Elements>::name("array elements");
+	Sampler<Members>::name("object members");
+	for(auto period_ : { Sampler<Strings>::sample, Sampler<Keys>::sample, Sampler<Elements>::sample, Sampler<Members>::sample })
+		period_(1000);
+	ds::BenchmarkOptions options_;
+	options_.samples     = samples;
+	options_.min_samples = samples;
+	options_.warmup_time = 0;
+	ds::Benchmark suite_ { "allocator_stats", options_ };
+	printf("-- %zu documents of %zu nodes\n", total_docs, doc_nodes);
+	for(size_t threads_ = 1; threads_ <= thread_max; threads_ *= 2)
+	{
+		run<Raw>(suite_, "raw", threads_);
+		run<Off>(suite_, "disabled", threads_);
+		run<On>(suite_, "enabled", threads_);
+		run<Sampler>(suite_, "sampled", threads_);
+	}
+	StdOut out_;
+	ds::AllocatorStats::write(out_, 4);
+}
@@ -0,0 +1,165 @@
+#include <ds/all>
+#include <ds/arena>
+#include <ds/benchmark>
+
+// Requests that each build a json-shaped document through an AllocatorBase
+// and drop it, one in sixteen of them ten times as large as the others, like
+// a server handling mostly small and a few large bodies. The heap frees every
+// node, the arenas are reset after each request and keep their blocks. An
+// iteration handles every request once.
+
+static constexpr size_t samples       = 5;
+static constexpr size_t request_count = 1 << 12;
+static constexpr size_t doc_nodes     = 1024;
+
+struct Heap : ds::AllocatorBase
+{
+	DS_nodiscard void *
+	allocate(size_t size_, size_t align_ = alignof(ds::max_align_t)) noexcept(false) override
+	{
+		return ds::DefaultAllocator::allocate(size_, align_);
+	}
+
+	void
+	deallocate(void * block_) noexcept override
+	{
+		ds::DefaultAllocator::deallocate(block_);
+	}
+};
+
+enum class Kind : uint8_t { integer, string, array, object };
+
+struct Node
+{
+	Kind     kind;
+	uint32_t count;
+	union
+	{
+		int64_t  integer;
+		char   * string;
+		Node   * children;
+	};
+	char ** keys;
+};
+
+static char *
+make_string(ds::AllocatorBase & a_, uint64_t & state_)
+{
+	auto const size_ = 4 + ds::xorshift(state_) % 40;
+	auto     * text_ = static_cast<char *>(a_.allocate(size_ + 1, 1));
+	for(size_t i = 0; i < size_; ++i)
+		text_[i] = char('a' + ds::xorshift(state_) % 26);
+	text_[size_] = '\0';
+	return text_;
+}
+
+static void
+build(ds::AllocatorBase & a_, Node & node_, uint64_t & state_, size_t & budget_)
+{
+	auto const roll_ = ds::xorshift(state_) % 8;
+	node_.keys  = nullptr;
+	node_.count = 0;
+	if(budget_ < 4 || roll_ < 3)
+	{
+		node_.kind    = Kind::integer;
+		node_.integer = int64_t(ds::xorshift(state_));
+	}
+	else if(roll_ < 5)
+	{
+		node_.kind   = Kind::string;
+		node_.string = make_string(a_, state_);
+	}
+	else
+	{
+		auto const count_ = uint32_t(1 + ds::xorshift(state_) % (budget_ < 12 ? budget_ : 12));
+		budget_ -= count_;
+		node_.count    = count_;
+		node_.kind     = roll_ < 6 ? Kind::array : Kind::object;
+		node_.children = static_cast<Node *>(a_.allocate(count_ * sizeof(Node), alignof(Node)));
+		if(node_.kind == Kind::object)
+			node_.keys = static_cast<char **>(a_.allocate(count_ * sizeof(char *), alignof(char *)));
+		for(uint32_t i = 0; i < count_; ++i)
+		{
+			if(node_.keys)
+				node_.keys[i] = make_string(a_, state_);
+			build(a_, node_.children[i], state_, budget_);
+		}
+	}
+}
+
+// checksum of the document, freeing every node when free_
+static uint64_t
+destroy(ds::AllocatorBase & a_, Node & node_, bool free_)
+{
+	if(node_.kind == Kind::integer)
+		return uint64_t(node_.integer);
+	if(node_.kind == Kind::string)
+	{
+		auto const sum_ = uint64_t(node_.string[0]);
+		if(free_)
+			a_.deallocate(node_.string);
+		return sum_;
+	}
+	uint64_t sum_ = 0;
+	for(uint32_t i = 0; i < node_.count; ++i)
+	{
+		if(node_.keys)
+		{
+			sum_ += uint64_t(node_.keys[i][0]);
+			if(free_)
+				a_.deallocate(node_.keys[i]);
+		}
+		sum_ += destroy(a_, node_.children[i], free_);
+	}
+	if(free_)
+	{
+		a_.deallocate(node_.keys);
+		a_.deallocate(node_.children);
+	}
+	return sum_;
+}
+
+static uint64_t
+request(ds::AllocatorBase & a_, size_t index_, bool free_)
+{
+	uint64_t state_  = 0x9e3779b97f4a7c15ULL + index_;
+	size_t   budget_ = index_ % 16 == 0 ? doc_nodes * 10 : doc_nodes;
+	Node     root_;
+	root_.kind = Kind::integer;
+	while(root_.kind == Kind::integer && budget_ >= 4)
+		build(a_, root_, state_, budget_);
+	return destroy(a_, root_, free_);
+}
+
+int main()
+{
+	ds::BenchmarkOptions options_;
+	options_.samples     = samples;
+	options_.min_samples = samples;
+	ds::Benchmark suite_ { "arena", options_ };
+	printf("-- %zu requests of about %zu nodes\n", request_count, doc_nodes);
+	{
+		uint64_t sum_ = 0;
+		Heap     heap_;
+		suite_.run("heap, freed", [&]()
+		{
+			for(size_t i = 0; i < request_count; ++i)
+				sum_ += request(heap_, i, true);
+		}, { 0, double(request_count) });
+		printf("  checksum %llu\n", (unsigned long long)sum_);
+	}
+	for(auto huge_pages_ : { false, true })
+	{
+		uint64_t  sum_ = 0;
+		ds::Arena arena_ { ds::Arena::default_block_size, huge_pages_ };
+		suite_.run(huge_pages_ ? "arena, huge pages" : "arena", [&]()
+		{
+			for(size_t i = 0; i < request_count; ++i)
+			{
+				ds::ArenaScope<> scope_ { arena_ };
+				sum_ += request(arena_, i, false);
+			}
+		}, { 0, double(request_count) });
+		printf("  checksum %llu, %zu blocks, %zu bytes reserved\n", (unsigned long long)sum_, arena_.block_count(), arena_.reserved());
+	}
+}
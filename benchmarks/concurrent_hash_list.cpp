@@ -0,0 +1,143 @@
+#include <ds/all>
+#include <ds/thread>
+#include <ds/mutex>
+#include <ds/hash_list>
+#include <ds/concurrent_hash_list>
+#include <ds/futex>
+#include <ds/benchmark>
+
+// Mixed read/write throughput of ConcurrentHashList against a HashList
+// shared behind a single ds::Mutex, at 1 to 64 threads. The threads are
+// started once per mix and thread count and then released together for every
+// iteration, so only the operations are timed.
+
+static constexpr size_t samples      = 5;
+static constexpr size_t table_size   = 4096;
+static constexpr size_t key_range    = 1 << 16;
+static constexpr size_t op_count     = 1 << 20; // per run, split between the threads
+
+static constexpr size_t thread_max      = 64;
+static constexpr size_t thread_counts[] = { 1, 2, 4, 8, 16, 32, thread_max };
+static constexpr size_t read_percents[] = { 100, 95, 80, 50 };
+
+// time routine_(thread_index, op_count / n) run on n threads at once
+template <typename F>
+static void
+run_threads(ds::Benchmark & suite_, char const * name_, size_t n, F && routine_)
+{
+	ds::FutexSemaphore start_[thread_max];
+	ds::FutexSemaphore done_;
+	std::atomic<bool>  stop_ { false };
+	auto const cpus_ = ds::sys::nprocessors();
+	size_t     index_ = 0;
+	auto threads_ = ds::stack<ds::thread>(n, [&]()
+	{
+		auto i = index_++;
+		return ds::thread({ uint64_t(1) << (i % cpus_ % 64), "bench" }, [&, i](ds::persistent<ds::thread *> thread)
+		{
+			if(!thread || thread->is_terminating())
+				return;
+			for(;;)
+			{
+				start_[i].await();
+				if(stop_.load(std::memory_order_acquire))
+					return;
+				routine_(i, op_count / n);
+				done_.signal();
+			}
+		});
+	});
+	suite_.run(name_, [&]()
+	{
+		for(size_t i = 0; i < n; ++i)
+			start_[i].signal();
+		for(size_t i = 0; i < n; ++i)
+			done_.await();
+	}, { 0, double(op_count) });
+	stop_.store(true, std::memory_order_release);
+	for(size_t i = 0; i < n; ++i)
+		start_[i].signal();
+	for(auto & thread_ : threads_)
+		thread_.join();
+}
+
+template <class L, typename R, typename W>
+static void
+run_mix(ds::Benchmark & suite_, char const * label_, L & list_, R && read_, W && write_)
+{
+	for(auto read_percent : read_percents)
+	{
+		for(auto n : thread_counts)
+		{
+			std::atomic<size_t> hits_ { 0 };
+			char                name_[64];
+			snprintf(name_, sizeof(name_), "%-20s %3zu%% reads %2zu threads", label_, read_percent, n);
+			run_threads(suite_, name_, n, [&](size_t i, size_t count_)
+			{
+				uint64_t state_ = 0x9e3779b97f4a7c15ULL * (i + 1);
+				size_t   hits   = 0;
+				for(size_t j = 0; j < count_; ++j)
+				{
+					auto r   = ds::xorshift(state_);
+					auto key = size_t(r % key_range);
+					if((r >> 32) % 100 < read_percent)
+						hits += read_(list_, key);
+					else
+						write_(list_, key, (r >> 40) & 1);
+				}
+				hits_ += hits;
+			});
+			printf("  %zu hits\n", hits_.load());
+		}
+	}
+}
+
+int main()
+{
+	ds::BenchmarkOptions options_;
+	options_.samples     = samples;
+	options_.min_samples = samples;
+	ds::Benchmark suite_ { "concurrent_hash_list", options_ };
+	{
+		auto list_ = ds::concurrent_hash_list<table_size,size_t>();
+		for(size_t key = 0; key < key_range; key += 2)
+			list_.insert_unique(key);
+		run_mix(suite_, "concurrent_hash_list", list_
+			, [](decltype(list_) & l, size_t key) -> size_t
+			{
+				return l.contains(key) ? 1 : 0;
+			}
+			, [](decltype(list_) & l, size_t key, bool insert_)
+			{
+				if(insert_)
+					l.insert_unique(key);
+				else
+					l.remove(key);
+			});
+		ds::epoch::synchronize();
+	}
+	{
+		struct locked_list_t
+		{
+			ds::mutex                       mutex;
+			ds::hash_list<table_size,size_t> list;
+		};
+		auto list_ = locked_list_t();
+		for(size_t key = 0; key < key_range; key += 2)
+			list_.list.insert_unique(key);
+		run_mix(suite_, "hash_list + mutex", list_
+			, [](locked_list_t & l, size_t key) -> size_t
+			{
+				auto lock = ds::mutex_lock(l.mutex);
+				return l.list.position_of(key) != l.list.end() ? 1 : 0;
+			}
+			, [](locked_list_t & l, size_t key, bool insert_)
+			{
+				auto lock = ds::mutex_lock(l.mutex);
+				if(insert_)
+					l.list.insert_unique(key);
+				else
+					l.list.remove(key);
+			});
+	}
+}
@@ -0,0 +1,205 @@
+#include <deque>
+#include <ds/all>
+#include <ds/thread>
+#include <ds/futex>
+#include <ds/concurrent_queue>
+#include <ds/benchmark>
+
+// ds::SpscRing and ds::MpmcQueue throughput across producer/consumer counts,
+// one at a time and in batches, against a mutex and condition variable protected
+// deque, and round-trip latency through a pair of queues. An iteration starts
+// the threads and moves every item once, a few samples of one each are taken.
+
+static constexpr size_t samples     = 3;
+static constexpr size_t item_count  = size_t(1) << 22;
+static constexpr size_t capacity    = 1024;
+static constexpr size_t batch       = 32;
+static constexpr size_t round_trips = 200000;
+
+// what pipeline stages use today
+template <typename E>
+class LockedQueue
+{
+	ds::FutexMutex<>           _mutex {};
+	ds::FutexConditionVariable _not_empty {};
+	ds::FutexConditionVariable _not_full  {};
+	std::deque<E>              _items {};
+	size_t                     _capacity;
+	bool                       _closed = false;
+
+ public:
+	LockedQueue(size_t capacity_) : _capacity { capacity_ } {}
+
+	bool
+	push(E const & object_)
+	{
+		ds::FutexMutexGuard<> guard_ { _mutex };
+		_not_full.wait(_mutex, [&]() { return _items.size() < _capacity || _closed; });
+		if(_closed)
+			return false;
+		_items.push_back(object_);
+		_not_empty.notify_one();
+		return true;
+	}
+
+	bool
+	pop(E & out_)
+	{
+		ds::FutexMutexGuard<> guard_ { _mutex };
+		_not_empty.wait(_mutex, [&]() { return !_items.empty() || _closed; });
+		if(_items.empty())
+			return false;
+		out_ = _items.front();
+		_items.pop_front();
+		_not_full.notify_one();
+		return true;
+	}
+
+	void
+	close()
+	{
+		{
+			ds::FutexMutexGuard<> guard_ { _mutex };
+			_closed = true;
+		}
+		_not_empty.notify_all();
+		_not_full.notify_all();
+	}
+};
+
+template <class Q, class Produce, class Consume>
+static void
+run(ds::Benchmark & suite_, char const * name_, size_t producers_, size_t consumers_, Produce && produce_, Consume && consume_)
+{
+	char label_[80];
+	snprintf(label_, sizeof(label_), "%-22s %2zu x %-2zu", name_, producers_, consumers_);
+	std::atomic<uint64_t> sum_ { 0 };
+	suite_.run(label_, [&]()
+	{
+		Q      queue_(capacity);
+		size_t index_ = 0;
+		auto   producer_threads_ = ds::Stack<ds::Thread>(producers_, [&]()
+		{
+			auto i = index_++;
+			return ds::Thread({ 0, "ds_producer" }, [&, i](ds::Persistent<ds::Thread *>)
+			{
+				produce_(queue_, item_count * i / producers_, item_count * (i + 1) / producers_);
+			});
+		});
+		auto consumer_threads_ = ds::Stack<ds::Thread>(consumers_, [&]()
+		{
+			return ds::Thread({ 0, "ds_consumer" }, [&](ds::Persistent<ds::Thread *>)
+			{
+				sum_.fetch_add(consume_(queue_), std::memory_order_relaxed);
+			});
+		});
+		for(auto & thread_ : producer_threads_)
+			thread_.join();
+		queue_.close();
+		for(auto & thread_ : consumer_threads_)
+			thread_.join();
+	}, { double(item_count * sizeof(uint64_t)), double(item_count) });
+	printf("  checksum %llu\n", (unsigned long long)sum_.load());
+}
+
+template <class Q>
+static void
+push_each(Q & queue_, size_t begin_, size_t end_)
+{
+	for(auto i = begin_; i < end_; ++i)
+		queue_.push(uint64_t(i));
+}
+
+template <class Q>
+static uint64_t
+pop_each(Q & queue_)
+{
+	uint64_t sum_ = 0, value_;
+	while(queue_.pop(value_))
+		sum_ += value_;
+	return sum_;
+}
+
+template <class Q>
+static void
+push_batches(Q & queue_, size_t begin_, size_t end_)
+{
+	uint64_t values_[batch];
+	for(auto i = begin_; i < end_;)
+	{
+		size_t count_ = end_ - i < batch ? end_ - i : batch;
+		for(size_t k = 0; k < count_; ++k)
+			values_[k] = uint64_t(i + k);
+		for(size_t done_ = 0; done_ < count_;)
+		{
+			auto pushed_ = queue_.try_push_bulk(values_ + done_, count_ - done_);
+			// full, block on one element
+			if(pushed_ == 0)
+				pushed_ = queue_.push(values_[done_]) ? 1 : count_;
+			done_ += pushed_;
+		}
+		i += count_;
+	}
+}
+
+template <class Q>
+static uint64_t
+pop_batches(Q & queue_)
+{
+	uint64_t sum_ = 0, values_[batch];
+	while(auto count_ = queue_.pop_bulk(values_, batch))
+		for(size_t k = 0; k < count_; ++k)
+			sum_ += values_[k];
+	return sum_;
+}
+
+// one thread bounces a token back through a second queue
+template <class Q>
+static void
+latency(ds::Benchmark & suite_, char const * name_)
+{
+	suite_.run(name_, [&]()
+	{
+		Q ping_(capacity), pong_(capacity);
+		ds::Thread thread_({ 0, "ds_echo" }, [&](ds::Persistent<ds::Thread *>)
+		{
+			uint64_t value_;
+			while(ping_.pop(value_))
+				pong_.push(value_);
+		});
+		uint64_t value_;
+		for(size_t i = 0; i < round_trips; ++i)
+		{
+			ping_.push(uint64_t(i));
+			pong_.pop(value_);
+		}
+		ping_.close();
+		thread_.join();
+	}, { 0, double(round_trips) });
+}
+
+int main()
+{
+	ds::BenchmarkOptions options_;
+	options_.samples     = samples;
+	options_.min_samples = samples;
+	options_.warmup_time = 0;
+	ds::Benchmark suite_ { "concurrent_queue", options_ };
+	using spsc_t   = ds::SpscRing<uint64_t>;
+	using mpmc_t   = ds::MpmcQueue<uint64_t>;
+	using locked_t = LockedQueue<uint64_t>;
+	printf("-- throughput, %zu items\n", item_count);
+	run<spsc_t>(suite_, "SpscRing", 1, 1, push_each<spsc_t>, pop_each<spsc_t>);
+	run<spsc_t>(suite_, "SpscRing batch", 1, 1, push_batches<spsc_t>, pop_batches<spsc_t>);
+	static constexpr size_t shapes[][2] = { { 1, 1 }, { 1, 4 }, { 4, 1 }, { 2, 2 }, { 4, 4 }, { 8, 8 } };
+	for(auto & shape_ : shapes)
+	{
+		run<mpmc_t>(suite_, "MpmcQueue", shape_[0], shape_[1], push_each<mpmc_t>, pop_each<mpmc_t>);
+		run<mpmc_t>(suite_, "MpmcQueue batch", shape_[0], shape_[1], push_batches<mpmc_t>, pop_batches<mpmc_t>);
+		run<locked_t>(suite_, "mutex + deque", shape_[0], shape_[1], push_each<locked_t>, pop_each<locked_t>);
+	}
+	printf("-- round trip x %zu\n", round_trips);
+	latency<spsc_t>(suite_, "SpscRing");
+	latency<mpmc_t>(suite_, "MpmcQueue");
+	latency<locked_t>(suite_, "mutex + deque");
+}
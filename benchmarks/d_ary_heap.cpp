@@ -0,0 +1,125 @@
+#include <ds/all>
+#include <ds/heap>
+#include <ds/d_ary_heap>
+#include <ds/benchmark>
+
+// ds::d_ary_heap at arity 2, 4 and 8 against the fixed capacity ds::max_heap on
+// 1M push/pop workloads, and ds::indexed_d_ary_heap on a decrease-key heavy one.
+// An iteration runs the whole workload.
+
+static constexpr size_t count   = 1000000;
+static constexpr size_t samples = 5;
+
+static ds::array<uint64_t> values(count, uint64_t());
+
+// push everything, then pop everything
+template <class H>
+static void
+push_pop(ds::Benchmark & suite_, char const * label_, H & heap_)
+{
+	uint64_t sum_ = 0;
+	suite_.run(label_, [&]()
+	{
+		for(size_t i = 0; i < count; ++i)
+			heap_.push(values[i]);
+		for(size_t i = 0; i < count; ++i)
+			sum_ += heap_.pop();
+	}, { 0, double(count) });
+	printf("  checksum %llu\n", (unsigned long long)sum_);
+}
+
+// keep the heap at half size and alternate pushes and pops
+template <class H>
+static void
+steady(ds::Benchmark & suite_, char const * label_, H & heap_)
+{
+	uint64_t sum_ = 0;
+	suite_.run(label_, [&]()
+	{
+		for(size_t i = 0; i < count / 2; ++i)
+			heap_.push(values[i]);
+		for(size_t i = count / 2; i < count; ++i)
+		{
+			heap_.push(values[i]);
+			sum_ += heap_.pop();
+		}
+		for(size_t i = 0; i < count / 2; ++i)
+			sum_ += heap_.pop();
+	}, { 0, double(count) });
+	printf("  checksum %llu\n", (unsigned long long)sum_);
+}
+
+template <size_t arity_>
+static void
+run_d_ary(ds::Benchmark & suite_, char const * name_)
+{
+	char label_[64];
+	ds::d_ary_heap<uint64_t,ds::greater<uint64_t>,ds::DefaultAllocator,arity_> heap_;
+	snprintf(label_, sizeof(label_), "%s push/pop", name_);
+	push_pop(suite_, label_, heap_);
+	snprintf(label_, sizeof(label_), "%s steady  ", name_);
+	steady(suite_, label_, heap_);
+	snprintf(label_, sizeof(label_), "%s bulk/pop", name_);
+	uint64_t sum_ = 0;
+	suite_.run(label_, [&]()
+	{
+		heap_.push_bulk(&values[0], &values[0] + count);
+		for(size_t i = 0; i < count; ++i)
+			sum_ += heap_.pop();
+	}, { 0, double(count) });
+	printf("  checksum %llu\n", (unsigned long long)sum_);
+}
+
+// a dijkstra-like pattern: every pop lowers the key of a few other entries
+template <size_t arity_>
+static void
+run_indexed(ds::Benchmark & suite_, char const * name_)
+{
+	using heap_t   = ds::indexed_d_ary_heap<uint64_t,ds::less<uint64_t>,ds::DefaultAllocator,arity_>;
+	using handle_t = typename heap_t::handle_t;
+	heap_t heap_(count);
+	auto   handles_ = ds::array<handle_t>(count, handle_t());
+	auto   keys_    = ds::array<uint64_t>(count, uint64_t());
+	uint64_t sum_ = 0;
+	suite_.run(name_, [&]()
+	{
+		uint64_t state_ = 0x2545f4914f6cdd1dULL;
+		for(size_t i = 0; i < count; ++i)
+			keys_[i] = values[i] >> 1;
+		heap_.push_bulk(&keys_[0], &keys_[0] + count, &handles_[0]);
+		while(heap_)
+		{
+			uint64_t const top_ = heap_.pop();
+			sum_ += top_;
+			for(int k = 0; k < 4; ++k)
+			{
+				handle_t const handle_ = handles_[ds::xorshift(state_) % count];
+				if(heap_.contains(handle_) && heap_[handle_] > top_)
+					heap_.decrease_key(handle_, top_ + (heap_[handle_] - top_) / 2);
+			}
+		}
+	}, { 0, double(count) });
+	printf("  checksum %llu\n", (unsigned long long)sum_);
+}
+
+int main()
+{
+	ds::BenchmarkOptions options_;
+	options_.samples     = samples;
+	options_.min_samples = samples;
+	ds::Benchmark suite_ { "d_ary_heap", options_ };
+	uint64_t state_ = 0x9e3779b97f4a7c15ULL;
+	for(size_t i = 0; i < count; ++i)
+		values[i] = ds::xorshift(state_) >> 16;
+	{
+		ds::max_heap<uint64_t> heap_(count);
+		push_pop(suite_, "ds::max_heap       push/pop", heap_);
+		steady(suite_, "ds::max_heap       steady  ", heap_);
+	}
+	run_d_ary<2>(suite_, "ds::d_ary_heap<2>");
+	run_d_ary<4>(suite_, "ds::d_ary_heap<4>");
+	run_d_ary<8>(suite_, "ds::d_ary_heap<8>");
+	run_indexed<2>(suite_, "ds::indexed_d_ary_heap<2> decrease_key");
+	run_indexed<4>(suite_, "ds::indexed_d_ary_heap<4> decrease_key");
+	run_indexed<8>(suite_, "ds::indexed_d_ary_heap<8> decrease_key");
+}
@@ -0,0 +1,207 @@
+#include <ds/all>
+#include <ds/thread>
+#include <ds/event_loop>
+#include <sys/socket.h>
+#include <ds/benchmark>
+
+// request/response round trips over 1-256 local socket pairs: a client writes a
+// 64 byte message, the server echoes it back, message_count times per pair.
+// Every pair on one ds::EventLoop thread against a blocking thread per pair.
+// An iteration sets up the pairs and runs every round trip once.
+
+static constexpr size_t samples       = 3;
+static constexpr size_t message_count = 2000;
+static constexpr size_t message_size  = 64;
+static constexpr size_t pair_max      = 256;
+
+struct Pair
+{
+	int  client = -1;
+	int  server = -1;
+	char client_buffer[message_size];
+	char server_buffer[message_size];
+
+	~Pair() noexcept
+	{
+		if(client >= 0)
+			::close(client);
+		if(server >= 0)
+			::close(server);
+	}
+
+	Pair()
+	{
+		int fds_[2];
+		if(socketpair(AF_UNIX, SOCK_STREAM, 0, fds_) == 0)
+		{
+			client = fds_[0];
+			server = fds_[1];
+		}
+		for(size_t i = 0; i < message_size; ++i)
+			client_buffer[i] = char('a' + i % 26);
+	}
+
+	Pair(Pair && rhs) noexcept
+		: client { rhs.client }
+		, server { rhs.server }
+	{
+		rhs.client = -1;
+		rhs.server = -1;
+		for(size_t i = 0; i < message_size; ++i)
+			client_buffer[i] = rhs.client_buffer[i];
+	}
+};
+
+// reads or writes exactly message_size bytes across partial transfers
+struct Transfer
+{
+	size_t done = 0;
+
+	template <class Io>
+	ds::IoAwait
+	step(int fd_, bool write_, Io && io_)
+	{
+		while(done < message_size)
+		{
+			auto const count_ = io_(done);
+			if(count_ > 0)
+				done += size_t(count_);
+			else if(count_ < 0 && errno == EAGAIN)
+				return write_ ? ds::IoAwait::writable(fd_) : ds::IoAwait::readable(fd_);
+			else
+				return ds::IoAwait::done();
+		}
+		done = 0;
+		return ds::IoAwait::yield();
+	}
+};
+
+static void
+event_loop(ds::Benchmark & suite_, size_t pair_count_)
+{
+	uint64_t sum_ = 0;
+	char     label_[64];
+	snprintf(label_, sizeof(label_), "EventLoop        %3zu pairs", pair_count_);
+	suite_.run(label_, [&]()
+	{
+		ds::EventLoop loop_;
+		auto pairs_ = ds::Stack<Pair>(pair_count_, []() { return Pair(); });
+		for(auto & pair_ : pairs_)
+		{
+			ds::EventLoop::set_nonblocking(pair_.client);
+			ds::EventLoop::set_nonblocking(pair_.server);
+			auto * p = &pair_;
+			// client: write a message, read the echo, message_count times
+			loop_.spawn([p, &sum_, sent_ = size_t(0), writing_ = true, transfer_ = Transfer()]() mutable
+			{
+				for(;;)
+				{
+					if(sent_ == message_count)
+						return ds::IoAwait::done();
+					auto const await_ = writing_
+						? transfer_.step(p->client, true,  [&](size_t at_) { return ::write(p->client, p->client_buffer + at_, message_size - at_); })
+						: transfer_.step(p->client, false, [&](size_t at_) { return ::read(p->client, p->client_buffer + at_, message_size - at_); });
+					if(await_.kind != ds::IoAwait::Kind::yield)
+						return await_;
+					if(!writing_)
+					{
+						sum_ += uint64_t(p->client_buffer[sent_ % message_size]);
+						++sent_;
+					}
+					writing_ = !writing_;
+				}
+			});
+			// server: echo every message
+			loop_.spawn([p, echoed_ = size_t(0), reading_ = true, transfer_ = Transfer()]() mutable
+			{
+				for(;;)
+				{
+					if(echoed_ == message_count)
+						return ds::IoAwait::done();
+					auto const await_ = reading_
+						? transfer_.step(p->server, false, [&](size_t at_) { return ::read(p->server, p->server_buffer + at_, message_size - at_); })
+						: transfer_.step(p->server, true,  [&](size_t at_) { return ::write(p->server, p->server_buffer + at_, message_size - at_); });
+					if(await_.kind != ds::IoAwait::Kind::yield)
+						return await_;
+					if(!reading_)
+						++echoed_;
+					reading_ = !reading_;
+				}
+			});
+		}
+		loop_.run();
+	}, { double(2 * message_size * message_count * pair_count_), double(message_count * pair_count_) });
+	printf("  checksum %llu\n", (unsigned long long)sum_);
+}
+
+static bool
+transfer_blocking(int fd_, char * data_, bool write_)
+{
+	for(size_t done_ = 0; done_ < message_size;)
+	{
+		auto const count_ = write_ ? ::write(fd_, data_ + done_, message_size - done_) : ::read(fd_, data_ + done_, message_size - done_);
+		if(count_ <= 0)
+			return false;
+		done_ += size_t(count_);
+	}
+	return true;
+}
+
+static void
+thread_per_pair(ds::Benchmark & suite_, size_t pair_count_)
+{
+	std::atomic<uint64_t> sum_ { 0 };
+	char                  label_[64];
+	snprintf(label_, sizeof(label_), "thread per pair  %3zu pairs", pair_count_);
+	suite_.run(label_, [&]()
+	{
+		auto   pairs_  = ds::Stack<Pair>(pair_count_, []() { return Pair(); });
+		size_t index_  = 0;
+		auto   servers_ = ds::Stack<ds::Thread>(pair_count_, [&]()
+		{
+			auto * p = &pairs_.begin()[index_++];
+			return ds::Thread({ 0, "ds_server" }, [p](ds::Persistent<ds::Thread *>)
+			{
+				for(size_t i = 0; i < message_count; ++i)
+					if(!transfer_blocking(p->server, p->server_buffer, false) || !transfer_blocking(p->server, p->server_buffer, true))
+						return;
+			});
+		});
+		index_ = 0;
+		auto clients_ = ds::Stack<ds::Thread>(pair_count_, [&]()
+		{
+			auto * p = &pairs_.begin()[index_++];
+			return ds::Thread({ 0, "ds_client" }, [p, &sum_](ds::Persistent<ds::Thread *>)
+			{
+				uint64_t local_ = 0;
+				for(size_t i = 0; i < message_count; ++i)
+				{
+					if(!transfer_blocking(p->client, p->client_buffer, true) || !transfer_blocking(p->client, p->client_buffer, false))
+						return;
+					local_ += uint64_t(p->client_buffer[i % message_size]);
+				}
+				sum_.fetch_add(local_, std::memory_order_relaxed);
+			});
+		});
+		for(auto & thread_ : clients_)
+			thread_.join();
+		for(auto & thread_ : servers_)
+			thread_.join();
+	}, { double(2 * message_size * message_count * pair_count_), double(message_count * pair_count_) });
+	printf("  checksum %llu\n", (unsigned long long)sum_.load());
+}
+
+int main()
+{
+	ds::BenchmarkOptions options_;
+	options_.samples     = samples;
+	options_.min_samples = samples;
+	options_.warmup_time = 0;
+	ds::Benchmark suite_ { "event_loop", options_ };
+	printf("-- %zu round trips of %zu bytes per pair\n", message_count, message_size);
+	for(size_t pairs_ = 1; pairs_ <= pair_max; pairs_ *= 4)
+	{
+		event_loop(suite_, pairs_);
+		thread_per_pair(suite_, pairs_);
+	}
+}
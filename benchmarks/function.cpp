@@ -0,0 +1,133 @@
+#include <ds/all>
+#include <ds/thread>
+#include <ds/concurrent_queue>
+#include <ds/function>
+#include <functional>
+#include <ds/benchmark>
+
+// cost of type erasing small closures on a task submission path: 4M closures
+// with 8 to 40 bytes of captures are wrapped, called and destroyed on one thread,
+// then handed from a producer to a consumer thread over a SpscRing. A heap
+// allocated object with a virtual call, as the prototype's icallable, and
+// std::function against ds::Function and ds::UniqueFunction. An iteration
+// handles every task once.
+
+static constexpr size_t samples    = 5;
+static constexpr size_t task_count = 1 << 22;
+static constexpr size_t ring_size  = 1024;
+
+// the prototype's icallable: one allocation and a virtual call per task
+struct VirtualTask
+{
+	virtual ~VirtualTask() noexcept = default;
+	virtual void operator()() = 0;
+};
+
+template <typename F>
+struct VirtualTaskOf : public VirtualTask
+{
+	F fn;
+
+	VirtualTaskOf(F fn_) : fn { ds::move(fn_) } {}
+
+	void operator()() override { fn(); }
+};
+
+struct VirtualWrapper
+{
+	VirtualTask * task = nullptr;
+
+	~VirtualWrapper() noexcept { delete task; }
+
+	VirtualWrapper() = default;
+
+	template <typename F>
+	VirtualWrapper(F && fn_) : task { new VirtualTaskOf<ds::remove_cvref_t<F>>(ds::forward<F>(fn_)) } {}
+
+	VirtualWrapper(VirtualWrapper && rhs) noexcept : task { rhs.task } { rhs.task = nullptr; }
+
+	VirtualWrapper &
+	operator=(VirtualWrapper && rhs) noexcept
+	{
+		delete task;
+		task     = rhs.task;
+		rhs.task = nullptr;
+		return *this;
+	}
+
+	void operator()() const { (*task)(); }
+};
+
+// closures of varying size as a scheduler sees them
+template <class W>
+static inline W
+make_task(uint64_t & sum_, size_t i)
+{
+	auto const a_ = uint64_t(i) * 0x9e3779b97f4a7c15ULL;
+	switch(i % 4)
+	{
+		case 0:  return W([&sum_]() { ++sum_; });
+		case 1:  return W([&sum_, i]() { sum_ += i; });
+		case 2:  return W([&sum_, i, a_]() { sum_ += i ^ a_; });
+		default: return W([&sum_, i, a_, b_ = a_ >> 7, c_ = a_ << 3]() { sum_ += i + a_ + b_ + c_; });
+	}
+}
+
+template <class W>
+static void
+wrap_and_call(ds::Benchmark & suite_, char const * name_)
+{
+	uint64_t sum_ = 0;
+	char     label_[64];
+	snprintf(label_, sizeof(label_), "%-16s wrap + call", name_);
+	suite_.run(label_, [&]()
+	{
+		for(size_t i = 0; i < task_count; ++i)
+		{
+			auto task_ = make_task<W>(sum_, i);
+			task_();
+		}
+	}, { 0, double(task_count) });
+	printf("  checksum %llu\n", (unsigned long long)sum_);
+}
+
+template <class W>
+static void
+submit(ds::Benchmark & suite_, char const * name_)
+{
+	uint64_t sum_ = 0;
+	char     label_[64];
+	snprintf(label_, sizeof(label_), "%-16s submit", name_);
+	suite_.run(label_, [&]()
+	{
+		ds::SpscRing<W> ring_(ring_size);
+		auto consumer_ = ds::Thread({ 0, "ds_consumer" }, [&](ds::Persistent<ds::Thread *>)
+		{
+			W task_;
+			while(ring_.pop(task_))
+				task_();
+		});
+		for(size_t i = 0; i < task_count; ++i)
+			ring_.push(make_task<W>(sum_, i));
+		ring_.close();
+		consumer_.join();
+	}, { 0, double(task_count) });
+	printf("  checksum %llu\n", (unsigned long long)sum_);
+}
+
+int main()
+{
+	ds::BenchmarkOptions options_;
+	options_.samples     = samples;
+	options_.min_samples = samples;
+	ds::Benchmark suite_ { "function", options_ };
+	printf("-- %zu tasks\n", task_count);
+	wrap_and_call<VirtualWrapper>(suite_, "virtual");
+	wrap_and_call<std::function<void()>>(suite_, "std::function");
+	wrap_and_call<ds::Function<void()>>(suite_, "Function");
+	wrap_and_call<ds::UniqueFunction<void()>>(suite_, "UniqueFunction");
+	submit<VirtualWrapper>(suite_, "virtual");
+	submit<std::function<void()>>(suite_, "std::function");
+	submit<ds::Function<void()>>(suite_, "Function");
+	submit<ds::UniqueFunction<void()>>(suite_, "UniqueFunction");
+}
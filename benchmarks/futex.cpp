@@ -0,0 +1,108 @@
+#include <pthread.h>
+#include <ds/all>
+#include <ds/thread>
+#include <ds/mutex>
+#include <ds/semaphore>
+#include <ds/futex>
+#include <ds/benchmark>
+
+// lock contention at 2-64 threads for ds::FutexMutex in both modes against
+// pthread_mutex_t, the current ds::Mutex and ds::SpinLock, and a semaphore
+// ping-pong between two threads for ds::FutexSemaphore against ds::Semaphore.
+// An iteration starts the threads and runs every operation once, so a few
+// samples of one iteration each are taken.
+
+static constexpr size_t samples      = 3;
+static constexpr size_t total_ops    = 1 << 21;
+static constexpr size_t ping_pongs   = 100000;
+static constexpr size_t thread_max   = 64;
+
+struct PthreadMutex
+{
+	pthread_mutex_t _mutex = PTHREAD_MUTEX_INITIALIZER;
+
+	~PthreadMutex() { pthread_mutex_destroy(&_mutex); }
+
+	inline void lock()    noexcept { pthread_mutex_lock(&_mutex); }
+	inline void release() noexcept { pthread_mutex_unlock(&_mutex); }
+};
+
+// every thread takes the lock total_ops / threads_ times, touches a shared counter
+// inside and does a little private work outside
+template <class M>
+static void
+contend(ds::Benchmark & suite_, char const * name_, size_t threads_)
+{
+	M        mutex_;
+	uint64_t counter_ = 0;
+	char     label_[64];
+	snprintf(label_, sizeof(label_), "%-16s %2zu threads", name_, threads_);
+	suite_.run(label_, [&]()
+	{
+		size_t index_   = 0;
+		auto   workers_ = ds::Stack<ds::Thread>(threads_, [&]()
+		{
+			auto i = index_++;
+			return ds::Thread({ 0, "ds_contend" }, [&, i](ds::Persistent<ds::Thread *>)
+			{
+				uint64_t state_ = 0x9e3779b97f4a7c15ULL + i;
+				for(size_t n = 0; n < total_ops / threads_; ++n)
+				{
+					mutex_.lock();
+					counter_ += ds::xorshift(state_) & 1;
+					mutex_.release();
+					for(size_t k = ds::xorshift(state_) % 64; k > 0; --k)
+						ds::xorshift(state_);
+				}
+			});
+		});
+		for(auto & thread_ : workers_)
+			thread_.join();
+	}, { 0, double(total_ops) });
+	printf("  counter %llu\n", (unsigned long long)counter_);
+}
+
+template <class S>
+static void
+ping_pong(ds::Benchmark & suite_, char const * name_)
+{
+	S ping_, pong_;
+	suite_.run(name_, [&]()
+	{
+		ds::Thread thread_({ 0b10, "ds_pong" }, [&](ds::Persistent<ds::Thread *>)
+		{
+			for(size_t i = 0; i < ping_pongs; ++i)
+			{
+				ping_.await();
+				pong_.signal();
+			}
+		});
+		for(size_t i = 0; i < ping_pongs; ++i)
+		{
+			ping_.signal();
+			pong_.await();
+		}
+		thread_.join();
+	}, { 0, double(ping_pongs) });
+}
+
+int main()
+{
+	ds::BenchmarkOptions options_;
+	options_.samples     = samples;
+	options_.min_samples = samples;
+	options_.warmup_time = 0;
+	ds::Benchmark suite_ { "futex", options_ };
+	for(size_t threads_ = 2; threads_ <= thread_max; threads_ *= 2)
+	{
+		printf("-- %zu threads\n", threads_);
+		contend<ds::FutexMutex<false>>(suite_, "FutexMutex", threads_);
+		contend<ds::FutexMutex<true>>(suite_, "FutexMutex fair", threads_);
+		contend<PthreadMutex>(suite_, "pthread_mutex", threads_);
+		contend<ds::Mutex>(suite_, "ds::Mutex", threads_);
+		contend<ds::SpinLock>(suite_, "ds::SpinLock", threads_);
+	}
+	printf("-- semaphore ping-pong x %zu\n", ping_pongs);
+	ping_pong<ds::FutexSemaphore>(suite_, "FutexSemaphore");
+	ping_pong<ds::Semaphore>(suite_, "ds::Semaphore");
+}
@@ -0,0 +1,453 @@
+#include <vector>
+#include <sys/resource.h>
+#include <ds/all>
+#include <ds/benchmark>
+#include <axl/resource/json.hpp>
+
+// json.hpp end to end on generated corpora shaped like the usual ones:
+//
+//   twitter  statuses with nested users and entities, mixed value types
+//   canada   a polygon feature of float coordinate pairs
+//   citm     many small objects and arrays of integers keyed by id
+//   deep     objects and arrays nested 1000 levels deep
+//   strings  long strings full of escapes and non-ASCII text
+//   ndjson   one log record per line
+//
+// Each is parsed with json::Parser, printed readable and compact, deep
+// copied, looked up key by key in random order and destroyed. Parse, copy and
+// destroy rates are in bytes of the corpus text, print rates in bytes
+// printed. The peak resident set of every corpus, text and all its copies
+// included, is printed after it, and appended to the DS_BENCHMARK_JSON file
+// with the results.
+
+namespace json = axl::json;
+
+struct Text
+{
+	char * data     = nullptr;
+	size_t size     = 0;
+	size_t capacity = 0;
+
+	Text(Text const &) = delete;
+	Text & operator=(Text const &) = delete;
+
+	~Text() noexcept
+	{
+		ds::DefaultAllocator::deallocate(data);
+	}
+
+	Text() = default;
+
+	void
+	append(char const * data_, size_t size_)
+	{
+		if(size_ == 0)
+			return;
+		if(size + size_ > capacity)
+		{
+			auto const capacity_ = size + size_ > capacity * 2 ? size + size_ : capacity * 2;
+			auto     * next_     = static_cast<char *>(ds::DefaultAllocator::allocate(capacity_, 1));
+			if(data)
+				memcpy(next_, data, size);
+			ds::DefaultAllocator::deallocate(data);
+			data     = next_;
+			capacity = capacity_;
+		}
+		memcpy(data + size, data_, size_);
+		size += size_;
+	}
+
+	void
+	append(char const * text_)
+	{
+		this->append(text_, strlen(text_));
+	}
+
+	template <typename... Args>
+	void
+	format(char const * format_, Args... args_)
+	{
+		char       buffer_[256];
+		auto const size_ = snprintf(buffer_, sizeof(buffer_), format_, args_...);
+		this->append(buffer_, size_t(size_) < sizeof(buffer_) ? size_t(size_) : sizeof(buffer_) - 1);
+	}
+};
+
+// json::print into a Text
+struct TextOutput : public axl::stream::Output
+{
+	Text & text;
+
+	TextOutput(Text & text_)
+		: text { text_ }
+	{}
+
+	size_t
+	write(void const * data_, size_t size_, size_t count_)
+	{
+		text.append(static_cast<char const *>(data_), size_ * count_);
+		return count_;
+	}
+};
+
+static char const * const words[] = {
+	  "the", "json", "parser", "allocates", "every", "node", "of", "a", "document", "while", "printing"
+	, "walks", "it", "again", "café", "naïve", "東京", "données", "🙂", "request", "latency", "cache"
+};
+
+static constexpr size_t word_count = sizeof(words) / sizeof(words[0]);
+
+// a quoted string of about size_ bytes, with an escape now and then
+static void
+sentence(Text & out_, uint64_t & state_, size_t size_)
+{
+	static char const * const escapes_[] = { "\\\"", "\\\\", "\\n", "\\t", "\\/", "\\u00e9", "\\ud83d\\ude00", "\\r" };
+	out_.append("\"");
+	for(size_t written_ = 0; written_ < size_;)
+	{
+		auto const roll_ = ds::xorshift(state_);
+		auto const word_ = roll_ % 16 == 0 ? escapes_[(roll_ >> 8) % 8] : words[(roll_ >> 8) % word_count];
+		out_.append(word_);
+		out_.append(" ");
+		written_ += strlen(word_) + 1;
+	}
+	out_.append("\"");
+}
+
+static void
+twitter(Text & out_)
+{
+	uint64_t state_ = 0x9e3779b97f4a7c15ULL;
+	out_.append("{\"statuses\":[");
+	for(size_t i = 0; i < 2000; ++i)
+	{
+		auto const id_   = 505874924095815681ULL + i * 7919;
+		auto const user_ = 1186275104ULL + ds::xorshift(state_) % 100000;
+		out_.append(i ? ",{" : "{");
+		out_.format("\"metadata\":{\"result_type\":\"recent\",\"iso_language_code\":\"%s\"},", i % 3 ? "ja" : "en");
+		out_.format("\"created_at\":\"Sun Aug 31 00:%02zu:%02zu +0000 2014\",\"id\":%llu,\"id_str\":\"%llu\",\"text\":", i / 60 % 60, i % 60, (unsigned long long)id_, (unsigned long long)id_);
+		sentence(out_, state_, 40 + ds::xorshift(state_) % 100);
+		out_.append(",\"source\":\"<a href=\\\"https://mobile.twitter.com\\\" rel=\\\"nofollow\\\">Mobile Web</a>\",\"truncated\":false");
+		out_.append(",\"in_reply_to_status_id\":null,\"in_reply_to_user_id\":null,\"in_reply_to_screen_name\":null");
+		out_.format(",\"user\":{\"id\":%llu,\"id_str\":\"%llu\",\"name\":", (unsigned long long)user_, (unsigned long long)user_);
+		sentence(out_, state_, 8);
+		out_.format(",\"screen_name\":\"user_%llu\",\"location\":", (unsigned long long)user_);
+		sentence(out_, state_, 10);
+		out_.append(",\"description\":");
+		sentence(out_, state_, 60 + ds::xorshift(state_) % 60);
+		out_.format(",\"url\":null,\"protected\":false,\"followers_count\":%llu,\"friends_count\":%llu,\"listed_count\":%llu"
+			, (unsigned long long)(ds::xorshift(state_) % 100000), (unsigned long long)(ds::xorshift(state_) % 5000), (unsigned long long)(ds::xorshift(state_) % 100));
+		out_.format(",\"created_at\":\"Mon Feb 17 16:%02zu:%02zu +0000 2014\",\"favourites_count\":%llu,\"utc_offset\":32400,\"time_zone\":\"Tokyo\"", i % 60, i / 60 % 60, (unsigned long long)(ds::xorshift(state_) % 3000));
+		out_.append(",\"geo_enabled\":false,\"verified\":false,\"statuses_count\":579,\"lang\":\"ja\",\"profile_background_color\":\"C0DEED\"");
+		out_.append(",\"profile_image_url\":\"http://pbs.twimg.com/profile_images/abc/normal.jpeg\",\"default_profile\":true,\"following\":false}");
+		out_.append(",\"geo\":null,\"coordinates\":null,\"place\":null,\"contributors\":null");
+		out_.format(",\"retweet_count\":%llu,\"favorite_count\":%llu,\"entities\":{\"hashtags\":[", (unsigned long long)(ds::xorshift(state_) % 100), (unsigned long long)(ds::xorshift(state_) % 100));
+		for(size_t h = 0, count_ = ds::xorshift(state_) % 4; h < count_; ++h)
+			out_.format("%s{\"text\":\"%s\",\"indices\":[%zu,%zu]}", h ? "," : "", words[ds::xorshift(state_) % word_count], h * 10, h * 10 + 8);
+		out_.append("],\"symbols\":[],\"urls\":[],\"user_mentions\":[");
+		for(size_t m = 0, count_ = ds::xorshift(state_) % 3; m < count_; ++m)
+		{
+			auto const mention_ = (unsigned long long)(ds::xorshift(state_) % 1000000);
+			out_.format("%s{\"screen_name\":\"user_%llu\",\"name\":\"user %llu\",\"id\":%llu,\"id_str\":\"%llu\",\"indices\":[3,%zu]}", m ? "," : "", mention_, mention_, mention_, mention_, 12 + m);
+		}
+		out_.format("]},\"favorited\":false,\"retweeted\":%s,\"lang\":\"%s\"}", i % 5 ? "false" : "true", i % 3 ? "ja" : "en");
+	}
+	out_.append("],\"search_metadata\":{\"completed_in\":0.087,\"max_id\":505874924095815681,\"query\":\"%E4%B8%80\",\"count\":2000}}");
+}
+
+static void
+canada(Text & out_)
+{
+	uint64_t state_ = 0x2545f4914f6cdd1dULL;
+	out_.append("{\"type\":\"FeatureCollection\",\"features\":[{\"type\":\"Feature\",\"properties\":{\"name\":\"Canada\"},\"geometry\":{\"type\":\"Polygon\",\"coordinates\":[");
+	for(size_t ring_ = 0; ring_ < 480; ++ring_)
+	{
+		out_.append(ring_ ? ",[" : "[");
+		auto longitude_ = -141.0 + double(ring_ % 80);
+		auto latitude_  = 42.0 + double(ring_ / 80) * 5;
+		for(size_t i = 0; i < 100; ++i)
+		{
+			longitude_ += double(int64_t(ds::xorshift(state_) % 2001) - 1000) * 1e-5;
+			latitude_  += double(int64_t(ds::xorshift(state_) % 2001) - 1000) * 1e-5;
+			out_.format("%s[%.15f,%.15f]", i ? "," : "", longitude_, latitude_);
+		}
+		out_.append("]");
+	}
+	out_.append("]}}]}");
+}
+
+static void
+citm(Text & out_)
+{
+	uint64_t state_ = 0xd1b54a32d192ed03ULL;
+	out_.append("{\"areaNames\":{");
+	for(size_t i = 0; i < 200; ++i)
+	{
+		out_.format("%s\"%zu\":", i ? "," : "", 205705993 + i);
+		sentence(out_, state_, 16);
+	}
+	out_.append("},\"events\":{");
+	for(size_t i = 0; i < 2000; ++i)
+	{
+		auto const id_ = 138586341 + i * 13;
+		out_.format("%s\"%zu\":{\"description\":null,\"id\":%zu,\"logo\":%s,\"name\":", i ? "," : "", id_, id_, i % 4 ? "null" : "\"/images/UE0AAAAACEKo6QAAAAZDSVRN\"");
+		sentence(out_, state_, 12 + ds::xorshift(state_) % 30);
+		out_.append(",\"subTopicIds\":[");
+		for(size_t t = 0, count_ = 1 + ds::xorshift(state_) % 5; t < count_; ++t)
+			out_.format("%s%zu", t ? "," : "", 337184262 + ds::xorshift(state_) % 100);
+		out_.append("],\"subjectCode\":null,\"subtitle\":null,\"topicIds\":[");
+		for(size_t t = 0, count_ = 1 + ds::xorshift(state_) % 3; t < count_; ++t)
+			out_.format("%s%zu", t ? "," : "", 324846099 + ds::xorshift(state_) % 10);
+		out_.append("]}");
+	}
+	out_.append("},\"performances\":[");
+	for(size_t i = 0; i < 2000; ++i)
+	{
+		out_.format("%s{\"eventId\":%zu,\"id\":%zu,\"logo\":null,\"name\":null,\"prices\":[", i ? "," : "", 138586341 + i * 13, 339887544 + i);
+		auto const prices_ = 1 + ds::xorshift(state_) % 4;
+		for(size_t p = 0; p < prices_; ++p)
+			out_.format("%s{\"amount\":%zu,\"audienceSubCategoryId\":337100890,\"seatCategoryId\":%zu}", p ? "," : "", 9500 + (ds::xorshift(state_) % 200) * 250, 338937295 + p);
+		out_.append("],\"seatCategories\":[");
+		for(size_t p = 0; p < prices_; ++p)
+		{
+			out_.format("%s{\"areas\":[", p ? "," : "");
+			for(size_t a = 0, count_ = 1 + ds::xorshift(state_) % 6; a < count_; ++a)
+				out_.format("%s{\"areaId\":%zu,\"blockIds\":[]}", a ? "," : "", 205705993 + ds::xorshift(state_) % 200);
+			out_.format("],\"seatCategoryId\":%zu}", 338937295 + p);
+		}
+		out_.format("],\"seatMapImage\":null,\"start\":%llu,\"venueCode\":\"PLEYEL_PLEYEL\"}", 1372701600000ULL + i * 86400000ULL);
+	}
+	out_.append("],\"venueNames\":{\"PLEYEL_PLEYEL\":\"Salle Pleyel\"}}");
+}
+
+static void
+deep(Text & out_)
+{
+	static constexpr size_t depth_ = 1000;
+	out_.append("[");
+	for(size_t chain_ = 0; chain_ < 64; ++chain_)
+	{
+		out_.append(chain_ ? "," : "");
+		for(size_t i = 0; i < depth_; ++i)
+			out_.format(i % 2 ? "[%zu," : "{\"level_%zu\":", i);
+		out_.append("null");
+		for(size_t i = depth_; i-- > 0;)
+			out_.append(i % 2 ? "]" : "}");
+	}
+	out_.append("]");
+}
+
+static void
+strings(Text & out_)
+{
+	uint64_t state_ = 0xbf58476d1ce4e5b9ULL;
+	out_.append("[");
+	for(size_t i = 0; i < 256; ++i)
+	{
+		out_.append(i ? "," : "");
+		sentence(out_, state_, 1024 + ds::xorshift(state_) % (16 << 10));
+	}
+	out_.append("]");
+}
+
+static void
+ndjson(Text & out_)
+{
+	static char const * const levels_[]  = { "debug", "info", "info", "info", "warn", "error" };
+	static char const * const methods_[] = { "GET", "GET", "GET", "POST", "PUT", "DELETE" };
+	uint64_t state_ = 0x94d049bb133111ebULL;
+	for(size_t i = 0; i < 20000; ++i)
+	{
+		out_.format("{\"ts\":\"2024-05-01T12:%02zu:%02zu.%03zuZ\",\"level\":\"%s\",\"logger\":\"http\",\"msg\":", i / 60000 % 60, i / 1000 % 60, i % 1000, levels_[ds::xorshift(state_) % 6]);
+		sentence(out_, state_, 20 + ds::xorshift(state_) % 40);
+		out_.format(",\"req\":{\"id\":\"%016llx\",\"method\":\"%s\",\"path\":\"/api/v1/items/%llu\",\"status\":%d,\"ms\":%.3f,\"bytes\":%llu}"
+			, (unsigned long long)ds::xorshift(state_), methods_[ds::xorshift(state_) % 6], (unsigned long long)(ds::xorshift(state_) % 100000)
+			, ds::xorshift(state_) % 10 ? 200 : 404, double(ds::xorshift(state_) % 100000) / 1000.0, (unsigned long long)(ds::xorshift(state_) % 65536));
+		out_.format(",\"tags\":[\"%s\",\"%s\"],\"retry\":%s}\n", words[ds::xorshift(state_) % word_count], words[ds::xorshift(state_) % word_count], i % 7 ? "false" : "true");
+	}
+}
+
+struct Corpus
+{
+	char const * name;
+	void      (* generate)(Text &);
+	size_t       peak_rss;
+	size_t       size;
+};
+
+struct Lookup
+{
+	json::Object const * object;
+	json::string_view_t  key;
+};
+
+// every key of every object under value_
+static void
+collect(json::Variant const & value_, std::vector<Lookup> & lookups_)
+{
+	if(value_.index == json::Variant::array_i && value_.array)
+	{
+		for(auto it = value_.array.elements().begin(); it; ++it)
+			collect(*it.ptr(), lookups_);
+	}
+	else if(value_.index == json::Variant::object_i && value_.object)
+	{
+		for(auto it = value_.object.entries().begin(); it; ++it)
+		{
+			auto const & key_ = it.ptr()->key();
+			lookups_.push_back({ &value_.object, json::string_view_t(key_.begin(), key_.begin() + key_.length()) });
+			collect(it.ptr()->value(), lookups_);
+		}
+	}
+}
+
+static void
+print(TextOutput & out_, json::Array const & values_, json::PrintSettings const & settings_)
+{
+	for(auto it = values_.elements().begin(); it; ++it)
+	{
+		json::print(out_, *it.ptr(), settings_);
+		out_.write("\n", 1, 1);
+	}
+}
+
+static void
+reset_peak_rss()
+{
+  #if defined(__linux__)
+	if(auto * file_ = fopen("/proc/self/clear_refs", "w"))
+	{
+		fputs("5", file_);
+		fclose(file_);
+	}
+  #endif
+}
+
+// bytes
+static size_t
+peak_rss()
+{
+  #if defined(__linux__)
+	if(auto * file_ = fopen("/proc/self/status", "r"))
+	{
+		char   line_[256];
+		size_t kib_ = 0;
+		while(fgets(line_, sizeof(line_), file_))
+			if(sscanf(line_, "VmHWM: %zu kB", &kib_) == 1)
+				break;
+		fclose(file_);
+		if(kib_ > 0)
+			return kib_ << 10;
+	}
+  #endif
+	rusage usage_;
+	getrusage(RUSAGE_SELF, &usage_);
+  #if defined(__APPLE__)
+	return size_t(usage_.ru_maxrss);
+  #else
+	return size_t(usage_.ru_maxrss) << 10;
+  #endif
+}
+
+static void
+measure(ds::Benchmark & suite_, Corpus & corpus_)
+{
+	Text text_;
+	corpus_.generate(text_);
+	corpus_.size = text_.size;
+	auto const bytes_ = double(text_.size);
+	char       name_[64];
+	json::Parser parser_;
+	parser_.feed(text_.data, text_.size);
+	if(parser_.finish() == json::Parser::error)
+	{
+		printf("%s: %s at %zu\n", corpus_.name, parser_.error_message(), parser_.offset());
+		return;
+	}
+	auto const values_ = parser_.take();
+	printf("-- %s, %.2f MiB\n", corpus_.name, bytes_ / double(1 << 20));
+
+	json::Array parsed_;
+	snprintf(name_, sizeof(name_), "%-8s parse", corpus_.name);
+	suite_.run_with_setup(name_, [&]() { parsed_ = json::Array(); }, [&]()
+	{
+		json::Parser local_;
+		local_.feed(text_.data, text_.size);
+		local_.finish();
+		parsed_ = local_.take();
+	}, { bytes_, 0 });
+	parsed_ = json::Array();
+
+	Text       printed_;
+	TextOutput out_ { printed_ };
+	for(auto readable_ : { true, false })
+	{
+		json::PrintSettings settings_;
+		settings_.readable = readable_;
+		print(out_, values_, settings_);
+		auto const size_ = double(printed_.size);
+		snprintf(name_, sizeof(name_), "%-8s print %s", corpus_.name, readable_ ? "readable" : "compact");
+		suite_.run(name_, [&]()
+		{
+			printed_.size = 0;
+			print(out_, values_, settings_);
+		}, { size_, 0 });
+		printed_.size = 0;
+	}
+
+	json::Array copy_;
+	snprintf(name_, sizeof(name_), "%-8s copy", corpus_.name);
+	suite_.run_with_setup(name_, [&]() { copy_ = json::Array(); }, [&]() { copy_ = values_; }, { bytes_, 0 });
+
+	std::vector<Lookup> lookups_;
+	for(auto it = values_.elements().begin(); it; ++it)
+		collect(*it.ptr(), lookups_);
+	if(!lookups_.empty())
+	{
+		uint64_t state_ = 0x9e3779b97f4a7c15ULL;
+		for(size_t i = lookups_.size() - 1; i > 0; --i)
+			ds::swap(lookups_[i], lookups_[ds::xorshift(state_) % (i + 1)]);
+		snprintf(name_, sizeof(name_), "%-8s lookup", corpus_.name);
+		suite_.run(name_, [&]()
+		{
+			size_t sum_ = 0;
+			for(auto const & lookup_ : lookups_)
+				sum_ += (*lookup_.object)[lookup_.key].index;
+			ds::do_not_optimize(sum_);
+		}, { 0, double(lookups_.size()) });
+	}
+
+	snprintf(name_, sizeof(name_), "%-8s destroy", corpus_.name);
+	suite_.run_with_setup(name_, [&]() { copy_ = values_; }, [&]() { copy_ = json::Array(); }, { bytes_, 0 });
+}
+
+int main()
+{
+	Corpus corpora_[] = {
+		  { "twitter", twitter, 0, 0 }
+		, { "canada",  canada,  0, 0 }
+		, { "citm",    citm,    0, 0 }
+		, { "deep",    deep,    0, 0 }
+		, { "strings", strings, 0, 0 }
+		, { "ndjson",  ndjson,  0, 0 }
+	};
+	{
+		ds::Benchmark suite_ { "json" };
+		for(auto & corpus_ : corpora_)
+		{
+			reset_peak_rss();
+			measure(suite_, corpus_);
+			corpus_.peak_rss = peak_rss();
+			printf("  peak RSS %.1f MiB\n", double(corpus_.peak_rss) / double(1 << 20));
+		}
+	}
+	if(auto const * path_ = getenv("DS_BENCHMARK_JSON"))
+		if(auto * file_ = fopen(path_, "a"))
+		{
+			fputs("{\"suite\":\"json peak_rss\",\"results\":[", file_);
+			for(size_t i = 0; i < sizeof(corpora_) / sizeof(corpora_[0]); ++i)
+				fprintf(file_, "%s{\"name\":\"%s\",\"text_bytes\":%zu,\"peak_rss\":%zu}", i ? "," : "", corpora_[i].name, corpora_[i].size, corpora_[i].peak_rss);
+			fputs("]}\n", file_);
+			fclose(file_);
+		}
+}
@@ -0,0 +1,93 @@
+#include <ds/all>
+#include <ds/thread>
+#include <ds/futex>
+#include <ds/log_sink>
+#include <fcntl.h>
+#include <ds/benchmark>
+
+// 1-16 threads logging 200k lines each to /dev/null: the samples' one shared
+// buffer formatted into under a mutex and written out when full, against
+// ds::LogSink with a ring per thread and formatting on the flusher. An
+// iteration starts the threads and logs every line once.
+
+static constexpr size_t samples       = 3;
+static constexpr size_t line_count    = 200000;
+static constexpr size_t thread_max    = 16;
+static constexpr size_t shared_buffer = 1024;
+
+// the sample's pattern: ds::string_stream<> sst(1024) behind sst_mutex
+struct SharedStream
+{
+	ds::FutexMutex<> mutex {};
+	int              fd;
+	size_t           size = 0;
+	char             buffer[shared_buffer];
+
+	SharedStream(int fd_) : fd { fd_ } {}
+
+	~SharedStream() noexcept
+	{
+		if(size > 0)
+			(void)!::write(fd, buffer, size);
+	}
+
+	void
+	line(size_t thread_, size_t index_, double value_)
+	{
+		ds::FutexMutexGuard<> guard_ { mutex };
+		if(shared_buffer - size < 128)
+		{
+			(void)!::write(fd, buffer, size);
+			size = 0;
+		}
+		auto const length_ = snprintf(buffer + size, shared_buffer - size, "worker %zu step %zu value %g\n", thread_, index_, value_);
+		size += size_t(length_ > 0 ? length_ : 0);
+	}
+};
+
+template <class Log>
+static void
+run(ds::Benchmark & suite_, char const * name_, size_t threads_, Log && log_)
+{
+	char label_[64];
+	snprintf(label_, sizeof(label_), "%-14s %2zu threads", name_, threads_);
+	suite_.run(label_, [&]()
+	{
+		size_t index_   = 0;
+		auto   workers_ = ds::Stack<ds::Thread>(threads_, [&]()
+		{
+			auto i = index_++;
+			return ds::Thread({ 0, "ds_logger" }, [&, i](ds::Persistent<ds::Thread *>)
+			{
+				for(size_t n = 0; n < line_count; ++n)
+					log_(i, n, double(n) * 0.5);
+			});
+		});
+		for(auto & thread_ : workers_)
+			thread_.join();
+	}, { 0, double(line_count * threads_) });
+}
+
+int main()
+{
+	ds::BenchmarkOptions options_;
+	options_.samples     = samples;
+	options_.min_samples = samples;
+	options_.warmup_time = 0;
+	ds::Benchmark suite_ { "log_sink", options_ };
+	auto const fd_ = ::open("/dev/null", O_WRONLY);
+	printf("-- %zu lines per thread\n", line_count);
+	for(size_t threads_ = 1; threads_ <= thread_max; threads_ *= 2)
+	{
+		{
+			SharedStream shared_ { fd_ };
+			run(suite_, "shared+mutex", threads_, [&](size_t t, size_t n, double v) { shared_.line(t, n, v); });
+		}
+		{
+			ds::LogSink sink_ { fd_ };
+			run(suite_, "LogSink", threads_, [&](size_t t, size_t n, double v) { sink_.line("worker ", t, " step ", n, " value ", v); });
+			sink_.flush();
+		}
+	}
+	::close(fd_);
+}
@@ -0,0 +1,110 @@
+#include <algorithm>
+#include <ds/all>
+#include <ds/thread>
+#include <ds/parallel_sort>
+#include <ds/benchmark>
+
+// ds::parallel_sort, ds::radix_sort and ds::pdqsort against std::sort on large
+// int64_t timestamp and double arrays, and the small block kernels on many
+// independent 16/64 element arrays. Each iteration copies the input before
+// sorting it, the copy costs the same for every sort.
+//
+// usage: parallel_sort [size]   (10M elements by default)
+
+static constexpr size_t samples = 3;
+
+template <typename E, typename F>
+static void
+run(ds::Benchmark & suite_, char const * label_, ds::array<E> const & source_, F && sort_)
+{
+	auto const size_ = source_.size();
+	auto       data_ = ds::array<E>(size_, E());
+	suite_.run(label_, [&]()
+	{
+		std::copy(&source_[0], &source_[0] + size_, &data_[0]);
+		sort_(&data_[0], &data_[0] + size_);
+		ds::clobber_memory();
+	}, { double(size_ * sizeof(E)), double(size_) });
+	if(!std::is_sorted(&data_[0], &data_[0] + size_))
+		printf("%s: not sorted!\n", label_);
+}
+
+template <typename E>
+static void
+run_all(ds::Benchmark & suite_, char const * type_, ds::array<E> const & source_)
+{
+	char name_[64];
+	printf("-- %s x %zu\n", type_, source_.size());
+	run(suite_, "std::sort", source_, [](E * b, E * e) { std::sort(b, e); });
+	run(suite_, "ds::pdqsort", source_, [](E * b, E * e) { ds::pdqsort(b, e); });
+	run(suite_, "ds::radix_sort", source_, [](E * b, E * e) { ds::radix_sort(b, e); });
+	for(size_t threads_ = 1; threads_ <= ds::sys::nprocessors(); threads_ *= 2)
+	{
+		snprintf(name_, sizeof(name_), "ds::parallel_sort %2zu", threads_);
+		run(suite_, name_, source_, [threads_](E * b, E * e) { ds::parallel_sort(b, e, ds::less<E>(), threads_); });
+	}
+}
+
+// sort size_ / block_ independent blocks
+template <typename E>
+static void
+run_blocks(ds::Benchmark & suite_, char const * type_, size_t size_, size_t block_)
+{
+	uint64_t state_  = 0x2545f4914f6cdd1dULL;
+	auto     source_ = ds::array<E>(size_, E());
+	auto     data_   = ds::array<E>(size_, E());
+	for(size_t i = 0; i < size_; ++i)
+		source_[i] = E(int64_t(ds::xorshift(state_) >> 1));
+	char name_[64];
+	snprintf(name_, sizeof(name_), "std::sort   %s/%zu", type_, block_);
+	suite_.run(name_, [&]()
+	{
+		std::copy(&source_[0], &source_[0] + size_, &data_[0]);
+		for(size_t i = 0; i + block_ <= size_; i += block_)
+			std::sort(&data_[i], &data_[i] + block_);
+		ds::clobber_memory();
+	}, { double(size_ * sizeof(E)), double(size_) });
+	snprintf(name_, sizeof(name_), "ds::pdqsort %s/%zu", type_, block_);
+	suite_.run(name_, [&]()
+	{
+		std::copy(&source_[0], &source_[0] + size_, &data_[0]);
+		for(size_t i = 0; i + block_ <= size_; i += block_)
+			ds::pdqsort(&data_[i], &data_[i] + block_);
+		ds::clobber_memory();
+	}, { double(size_ * sizeof(E)), double(size_) });
+}
+
+int main(int argc, char ** argv)
+{
+	ds::BenchmarkOptions options_;
+	options_.samples     = samples;
+	options_.min_samples = samples;
+	ds::Benchmark suite_ { "parallel_sort", options_ };
+	size_t size_ = argc > 1 ? size_t(strtoull(argv[1], nullptr, 10)) : size_t(10000000);
+	{
+		// nanosecond timestamps over about a day, arriving mostly in order
+		uint64_t state_  = 0x9e3779b97f4a7c15ULL;
+		auto     source_ = ds::array<int64_t>(size_, int64_t());
+		int64_t  base_   = int64_t(1700000000) * 1000000000;
+		for(size_t i = 0; i < size_; ++i)
+			source_[i] = base_ + int64_t(i) * 8640 + int64_t(ds::xorshift(state_) % 1000000000);
+		run_all<int64_t>(suite_, "int64 timestamps", source_);
+		for(size_t i = 0; i < size_; ++i)
+			source_[i] = base_ + int64_t(ds::xorshift(state_) % (uint64_t(1) << 32));
+		run_all<int64_t>(suite_, "int64 32-bit spread", source_);
+		for(size_t i = 0; i < size_; ++i)
+			source_[i] = int64_t(ds::xorshift(state_));
+		run_all<int64_t>(suite_, "int64 random", source_);
+	}
+	{
+		uint64_t state_  = 0x9e3779b97f4a7c15ULL;
+		auto     source_ = ds::array<double>(size_, 0.0);
+		for(size_t i = 0; i < size_; ++i)
+			source_[i] = double(int64_t(ds::xorshift(state_))) * 1e-9;
+		run_all<double>(suite_, "double random", source_);
+	}
+	run_blocks<int32_t>(suite_, "int32", size_t(1) << 22, 64);
+	run_blocks<float>(suite_, "float", size_t(1) << 22, 64);
+	run_blocks<int64_t>(suite_, "int64", size_t(1) << 22, 16);
+	run_blocks<double>(suite_, "double", size_t(1) << 22, 16);
+}
@@ -0,0 +1,160 @@
+#include <ds/all>
+#include <ds/thread>
+#include <ds/futex>
+#include <ds/rw_lock>
+#include <ds/snapshot>
+#include <ds/benchmark>
+
+// read-mostly access to a small lookup table at 1-64 threads, one write per
+// write_period reads: ds::FutexMutex against ds::ReadWriteLock and
+// ds::Snapshot, and a small POD behind ds::SeqLock. An iteration starts the
+// threads and does every read once.
+
+static constexpr size_t samples      = 3;
+static constexpr size_t total_reads  = 1 << 22;
+static constexpr size_t write_period = 4096;
+static constexpr size_t thread_max   = 64;
+static constexpr size_t table_size   = 64;
+
+struct Table
+{
+	uint64_t values[table_size] {};
+};
+
+struct Stats
+{
+	uint64_t count = 0;
+	uint64_t sum   = 0;
+	uint64_t max   = 0;
+};
+
+struct MutexTable
+{
+	ds::FutexMutex<> _mutex {};
+	Table            _table {};
+
+	inline uint64_t
+	read(size_t i) noexcept
+	{
+		ds::FutexMutexGuard<> guard_ { _mutex };
+		return _table.values[i % table_size];
+	}
+
+	inline void
+	write(size_t i) noexcept
+	{
+		ds::FutexMutexGuard<> guard_ { _mutex };
+		++_table.values[i % table_size];
+	}
+};
+
+struct RwLockTable
+{
+	ds::ReadWriteLock _lock  {};
+	Table             _table {};
+
+	inline uint64_t
+	read(size_t i) noexcept
+	{
+		ds::ReadLockGuard guard_ { _lock };
+		return _table.values[i % table_size];
+	}
+
+	inline void
+	write(size_t i) noexcept
+	{
+		ds::WriteLockGuard guard_ { _lock };
+		++_table.values[i % table_size];
+	}
+};
+
+struct SnapshotTable
+{
+	ds::Snapshot<Table> _table { Table() };
+
+	inline uint64_t
+	read(size_t i) noexcept
+	{
+		return _table.read()->values[i % table_size];
+	}
+
+	inline void
+	write(size_t i) noexcept
+	{
+		_table.update([i](Table & table_) { ++table_.values[i % table_size]; });
+	}
+};
+
+struct SeqLockStats
+{
+	ds::SeqLock<Stats> _stats {};
+
+	inline uint64_t
+	read(size_t) noexcept
+	{
+		auto const stats_ = _stats.load();
+		return stats_.count + stats_.sum + stats_.max;
+	}
+
+	inline void
+	write(size_t i) noexcept
+	{
+		_stats.update([i](Stats & stats_)
+		{
+			++stats_.count;
+			stats_.sum += i;
+			stats_.max  = i > stats_.max ? i : stats_.max;
+		});
+	}
+};
+
+template <class T>
+static void
+read_mostly(ds::Benchmark & suite_, char const * name_, size_t threads_)
+{
+	T                     shared_;
+	std::atomic<uint64_t> sum_ { 0 };
+	char                  label_[64];
+	snprintf(label_, sizeof(label_), "%-16s %2zu threads", name_, threads_);
+	suite_.run(label_, [&]()
+	{
+		size_t index_   = 0;
+		auto   readers_ = ds::Stack<ds::Thread>(threads_, [&]()
+		{
+			auto i = index_++;
+			return ds::Thread({ 0, "ds_reader" }, [&, i](ds::Persistent<ds::Thread *>)
+			{
+				uint64_t local_ = 0;
+				for(size_t n = 0; n < total_reads / threads_; ++n)
+				{
+					if(n % write_period == i)
+						shared_.write(n);
+					else
+						local_ += shared_.read(n + i);
+				}
+				sum_.fetch_add(local_, std::memory_order_relaxed);
+			});
+		});
+		for(auto & thread_ : readers_)
+			thread_.join();
+	}, { 0, double(total_reads) });
+	printf("  checksum %llu\n", (unsigned long long)sum_.load());
+}
+
+int main()
+{
+	ds::BenchmarkOptions options_;
+	options_.samples     = samples;
+	options_.min_samples = samples;
+	options_.warmup_time = 0;
+	ds::Benchmark suite_ { "rw_lock", options_ };
+	for(size_t threads_ = 1; threads_ <= thread_max; threads_ *= 2)
+	{
+		printf("-- %zu threads\n", threads_);
+		read_mostly<MutexTable>(suite_, "FutexMutex", threads_);
+		read_mostly<RwLockTable>(suite_, "ReadWriteLock", threads_);
+		read_mostly<SnapshotTable>(suite_, "Snapshot", threads_);
+		read_mostly<SeqLockStats>(suite_, "SeqLock", threads_);
+	}
+	ds::Epoch::synchronize();
+}
@@ -0,0 +1,85 @@
+#include <algorithm>
+#include <ds/all>
+#include <ds/sort>
+#include <ds/benchmark>
+
+// ds::pdqsort against std::sort and the old ds::sort quick-sort on the usual
+// input patterns, for int, double and a non-arithmetic key. Each iteration
+// copies the input before sorting it, the copy costs the same for every sort.
+
+static constexpr size_t sizes[] = { 16, 1000, 100000, 1000000 };
+
+struct Key
+{
+	uint64_t hi, lo;
+
+	constexpr bool operator<(Key const & rhs) const noexcept { return hi < rhs.hi || (hi == rhs.hi && lo < rhs.lo); }
+	constexpr bool operator>(Key const & rhs) const noexcept { return rhs < *this; }
+};
+
+template <typename E> static inline E make(uint64_t v) { return E(v); }
+template <> inline Key make<Key>(uint64_t v) { return { v >> 4, v }; }
+
+enum class Pattern { random, sorted, reverse, few_unique, organ_pipe };
+
+static char const * const pattern_names[] = { "random", "sorted", "reverse", "few_unique", "organ_pipe" };
+
+template <typename E>
+static void
+fill(E * data_, size_t size_, Pattern pattern_)
+{
+	uint64_t state_ = 0x9e3779b97f4a7c15ULL;
+	for(size_t i = 0; i < size_; ++i)
+	{
+		switch(pattern_)
+		{
+			case Pattern::random:     data_[i] = make<E>(ds::xorshift(state_) >> 8); break;
+			case Pattern::sorted:     data_[i] = make<E>(i); break;
+			case Pattern::reverse:    data_[i] = make<E>(size_ - i); break;
+			case Pattern::few_unique: data_[i] = make<E>(ds::xorshift(state_) % 16); break;
+			case Pattern::organ_pipe: data_[i] = make<E>(i < size_ / 2 ? i : size_ - i); break;
+		}
+	}
+}
+
+template <typename E, typename F>
+static void
+run(ds::Benchmark & suite_, char const * type_, F && sort_, char const * label_)
+{
+	for(size_t p = 0; p < 5; ++p)
+	{
+		for(auto size_ : sizes)
+		{
+			auto source_ = ds::array<E>(size_, E());
+			auto data_   = ds::array<E>(size_, E());
+			fill(&source_[0], size_, Pattern(p));
+			char name_[64];
+			snprintf(name_, sizeof(name_), "%s %-7s %-10s %7zu", label_, type_, pattern_names[p], size_);
+			suite_.run(name_, [&]()
+			{
+				std::copy(&source_[0], &source_[0] + size_, &data_[0]);
+				sort_(&data_[0], &data_[0] + size_);
+				ds::clobber_memory();
+			}, { double(size_ * sizeof(E)), double(size_) });
+			if(!std::is_sorted(&data_[0], &data_[0] + size_))
+				printf("%s: not sorted!\n", name_);
+		}
+	}
+}
+
+template <typename E>
+static void
+run_all(ds::Benchmark & suite_, char const * type_)
+{
+	run<E>(suite_, type_, [](E * b, E * e) { ds::pdqsort(b, e); }, "ds::pdqsort");
+	run<E>(suite_, type_, [](E * b, E * e) { std::sort(b, e); }, "std::sort  ");
+	run<E>(suite_, type_, [](E * b, E * e) { ds::sort(b, e, ds::less<E>()); }, "ds::sort   ");
+}
+
+int main()
+{
+	ds::Benchmark suite_ { "sort" };
+	run_all<int32_t>(suite_, "int32");
+	run_all<double>(suite_, "double");
+	run_all<Key>(suite_, "key128");
+}
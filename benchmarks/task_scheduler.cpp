@@ -0,0 +1,143 @@
+#include <ds/all>
+#include <ds/thread>
+#include <ds/sort>
+#include <ds/thread_pool>
+#include <ds/task_scheduler>
+#include <ds/benchmark>
+
+// latency percentiles of 1M small tasks from spawn to start, per priority, on
+// ds::TaskScheduler against ds::ThreadPool, which has no priorities. tasks are
+// spawned in bursts from outside and from inside the workers, and a second round
+// has every task yield a few times before it finishes. An iteration spawns and
+// waits for every task.
+
+static constexpr size_t samples        = 3;
+static constexpr size_t task_count     = 1000000;
+static constexpr size_t burst          = 4096;
+static constexpr size_t priority_count = 4;
+static constexpr size_t task_work      = 64;
+static constexpr size_t yields         = 4;
+
+static inline int64_t
+now_ns() noexcept
+{
+	timespec time_;
+	clock_gettime(CLOCK_MONOTONIC, &time_);
+	return int64_t(time_.tv_sec) * 1000000000LL + int64_t(time_.tv_nsec);
+}
+
+struct Sample
+{
+	int64_t spawned = 0;
+	int64_t started = 0;
+};
+
+static uint64_t
+small_work(size_t seed_) noexcept
+{
+	uint64_t state_ = 0x9e3779b97f4a7c15ULL + seed_;
+	for(size_t i = 0; i < task_work; ++i)
+		ds::xorshift(state_);
+	return state_;
+}
+
+static void
+report(char const * name_, ds::array<Sample> & samples_)
+{
+	auto latencies_ = ds::array<int64_t>(task_count / priority_count, 0);
+	for(size_t p = priority_count; p-- > 0;)
+	{
+		size_t count_ = 0;
+		for(size_t i = p; i < task_count; i += priority_count)
+			latencies_[count_++] = samples_[i].started - samples_[i].spawned;
+		ds::pdqsort(&latencies_[0], &latencies_[0] + count_);
+		auto percentile_ = [&](double q_) { return double(latencies_[size_t(q_ * double(count_ - 1))]) / 1000.0; };
+		printf("  %-22s priority %zu  p50 %9.1fus  p90 %9.1fus  p99 %9.1fus  p99.9 %9.1fus  max %9.1fus\n"
+			, name_, p, percentile_(0.5), percentile_(0.9), percentile_(0.99), percentile_(0.999), percentile_(1.0));
+	}
+}
+
+// bursts of tasks with priorities p = i % priority_count, half of each burst
+// spawned by a task already running on a worker
+template <class Spawn, class Wait>
+static void
+run(ds::Benchmark & suite_, char const * name_, ds::array<Sample> & samples_, Spawn && spawn_, Wait && wait_)
+{
+	std::atomic<uint64_t> sum_ { 0 };
+	suite_.run(name_, [&]()
+	{
+		for(size_t begin_ = 0; begin_ < task_count; begin_ += burst)
+		{
+			auto const end_    = begin_ + burst < task_count ? begin_ + burst : task_count;
+			auto const middle_ = begin_ + (end_ - begin_) / 2;
+			spawn_(0, [&, middle_, end_]()
+			{
+				for(size_t i = middle_; i < end_; ++i)
+				{
+					samples_[i].spawned = now_ns();
+					spawn_(int(i % priority_count), [&, i]()
+					{
+						samples_[i].started = now_ns();
+						sum_.fetch_add(small_work(i), std::memory_order_relaxed);
+					});
+				}
+			});
+			for(size_t i = begin_; i < middle_; ++i)
+			{
+				samples_[i].spawned = now_ns();
+				spawn_(int(i % priority_count), [&, i]()
+				{
+					samples_[i].started = now_ns();
+					sum_.fetch_add(small_work(i), std::memory_order_relaxed);
+				});
+			}
+		}
+		wait_();
+	}, { 0, double(task_count) });
+	printf("  checksum %llu\n", (unsigned long long)sum_.load());
+	report(name_, samples_);
+}
+
+int main()
+{
+	ds::BenchmarkOptions options_;
+	options_.samples     = samples;
+	options_.min_samples = samples;
+	options_.warmup_time = 0;
+	ds::Benchmark suite_ { "task_scheduler", options_ };
+	auto samples_ = ds::array<Sample>(task_count, Sample());
+	for(size_t threads_ = 2; threads_ <= ds::sys::nprocessors() * 2; threads_ *= 2)
+	{
+		printf("-- %zu threads, %zu tasks\n", threads_, task_count);
+		{
+			ds::TaskScheduler scheduler_(threads_);
+			ds::WaitGroup     group_;
+			run(suite_, "TaskScheduler", samples_
+				, [&](int priority_, auto && fn_) { scheduler_.spawn(group_, priority_, ds::forward<decltype(fn_)>(fn_)); }
+				, [&]() { scheduler_.wait(group_); });
+		}
+		{
+			ds::ThreadPool pool_(threads_);
+			ds::WaitGroup  group_;
+			run(suite_, "ThreadPool", samples_
+				, [&](int, auto && fn_) { pool_.submit(group_, ds::forward<decltype(fn_)>(fn_)); }
+				, [&]() { pool_.wait(group_); });
+		}
+		{
+			// latency to the first slice, the task then yields a few times
+			ds::TaskScheduler scheduler_(threads_);
+			ds::WaitGroup     group_;
+			run(suite_, "TaskScheduler yield", samples_
+				, [&](int priority_, auto && fn_)
+				{
+					scheduler_.spawn(group_, priority_, [fn_, slices_ = size_t(0)]() mutable
+					{
+						if(slices_++ == 0)
+							fn_();
+						return slices_ <= yields ? ds::TaskStatus::yield : ds::TaskStatus::done;
+					});
+				}
+				, [&]() { scheduler_.wait(group_); });
+		}
+	}
+}
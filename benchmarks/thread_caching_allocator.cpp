@@ -0,0 +1,241 @@
+#include <ds/all>
+#include <ds/thread>
+#include <ds/concurrent_queue>
+#include <ds/thread_caching_allocator>
+#include <ds/benchmark>
+
+// json-shaped documents built by 1-16 threads at once: objects and arrays of
+// small nodes and short strings, every allocation going through the allocator
+// under test. Each thread either builds and frees its own documents, or half of
+// the threads build them and hand them over a queue to the other half, which
+// free them. DefaultAllocator against ds::ThreadCachingAllocator. An iteration
+// starts the threads and builds and frees every document once.
+
+static constexpr size_t samples       = 3;
+static constexpr size_t total_docs    = 1 << 12;
+static constexpr size_t doc_nodes     = 512;
+static constexpr size_t thread_max    = 16;
+
+enum class Kind : uint8_t { integer, string, array, object };
+
+// one json value, composites own an allocated child array and objects a key per child
+struct Node
+{
+	Kind     kind;
+	uint32_t count;
+	union
+	{
+		int64_t  integer;
+		char   * string;
+		Node   * children;
+	};
+	char ** keys;
+};
+
+template <class A>
+static char *
+make_string(uint64_t & state_)
+{
+	auto const size_ = 4 + ds::xorshift(state_) % 40;
+	auto     * text_ = static_cast<char *>(A::allocate(size_ + 1, 1));
+	for(size_t i = 0; i < size_; ++i)
+		text_[i] = char('a' + ds::xorshift(state_) % 26);
+	text_[size_] = '\0';
+	return text_;
+}
+
+// fills node_ with a random value, using up to budget_ nodes below it
+template <class A>
+static void
+build(Node & node_, uint64_t & state_, size_t & budget_)
+{
+	auto const roll_ = ds::xorshift(state_) % 8;
+	node_.keys = nullptr;
+	if(budget_ < 4 || roll_ < 3)
+	{
+		node_.kind    = Kind::integer;
+		node_.count   = 0;
+		node_.integer = int64_t(ds::xorshift(state_));
+	}
+	else if(roll_ < 5)
+	{
+		node_.kind   = Kind::string;
+		node_.count  = 0;
+		node_.string = make_string<A>(state_);
+	}
+	else
+	{
+		auto const count_ = uint32_t(1 + ds::xorshift(state_) % (budget_ < 12 ? budget_ : 12));
+		budget_ -= count_;
+		node_.kind     = roll_ < 6 ? Kind::array : Kind::object;
+		node_.count    = count_;
+		node_.children = static_cast<Node *>(A::allocate(count_ * sizeof(Node), alignof(Node)));
+		if(node_.kind == Kind::object)
+			node_.keys = static_cast<char **>(A::allocate(count_ * sizeof(char *), alignof(char *)));
+		for(uint32_t i = 0; i < count_; ++i)
+		{
+			if(node_.keys)
+				node_.keys[i] = make_string<A>(state_);
+			build<A>(node_.children[i], state_, budget_);
+		}
+	}
+}
+
+// checksum of the document, freeing it on the way
+template <class A>
+static uint64_t
+destroy(Node & node_)
+{
+	uint64_t sum_ = 0;
+	switch(node_.kind)
+	{
+		case Kind::integer:
+			sum_ = uint64_t(node_.integer);
+			break;
+		case Kind::string:
+			sum_ = uint64_t(node_.string[0]);
+			A::deallocate(node_.string);
+			break;
+		default:
+			for(uint32_t i = 0; i < node_.count; ++i)
+			{
+				if(node_.keys)
+				{
+					sum_ += uint64_t(node_.keys[i][0]);
+					A::deallocate(node_.keys[i]);
+				}
+				sum_ += destroy<A>(node_.children[i]);
+			}
+			A::deallocate(node_.keys);
+			A::deallocate(node_.children);
+	}
+	return sum_;
+}
+
+template <class A>
+static Node *
+make_document(uint64_t seed_)
+{
+	auto * root_   = static_cast<Node *>(A::allocate(sizeof(Node), alignof(Node)));
+	size_t budget_ = doc_nodes;
+	root_->kind     = Kind::object;
+	root_->count    = 0;
+	root_->keys     = nullptr;
+	root_->children = nullptr;
+	while(budget_ >= 4)
+	{
+		auto * old_keys_     = root_->keys;
+		auto * old_children_ = root_->children;
+		// grow the top level object like a parser would
+		root_->keys     = static_cast<char **>(A::allocate((root_->count + 1) * sizeof(char *), alignof(char *)));
+		root_->children = static_cast<Node *>(A::allocate((root_->count + 1) * sizeof(Node), alignof(Node)));
+		for(uint32_t i = 0; i < root_->count; ++i)
+		{
+			root_->keys[i]     = old_keys_[i];
+			root_->children[i] = old_children_[i];
+		}
+		A::deallocate(old_keys_);
+		A::deallocate(old_children_);
+		root_->keys[root_->count] = make_string<A>(seed_);
+		--budget_;
+		build<A>(root_->children[root_->count++], seed_, budget_);
+	}
+	return root_;
+}
+
+template <class A>
+static uint64_t
+destroy_document(Node * root_)
+{
+	auto sum_ = destroy<A>(*root_);
+	A::deallocate(root_);
+	return sum_;
+}
+
+template <class A>
+static void
+own_documents(ds::Benchmark & suite_, char const * name_, size_t threads_)
+{
+	std::atomic<uint64_t> sum_ { 0 };
+	char                  label_[64];
+	snprintf(label_, sizeof(label_), "%-16s own   %2zu threads", name_, threads_);
+	suite_.run(label_, [&]()
+	{
+		size_t index_   = 0;
+		auto   workers_ = ds::Stack<ds::Thread>(threads_, [&]()
+		{
+			auto i = index_++;
+			return ds::Thread({ 0, "ds_builder" }, [&, i](ds::Persistent<ds::Thread *>)
+			{
+				uint64_t local_ = 0;
+				for(size_t n = i; n < total_docs; n += threads_)
+					local_ += destroy_document<A>(make_document<A>(0x9e3779b97f4a7c15ULL + n));
+				sum_.fetch_add(local_, std::memory_order_relaxed);
+			});
+		});
+		for(auto & thread_ : workers_)
+			thread_.join();
+	}, { 0, double(total_docs) });
+	printf("  checksum %llu\n", (unsigned long long)sum_.load());
+}
+
+template <class A>
+static void
+handed_documents(ds::Benchmark & suite_, char const * name_, size_t threads_)
+{
+	std::atomic<uint64_t> sum_ { 0 };
+	char                  label_[64];
+	snprintf(label_, sizeof(label_), "%-16s moved %2zu threads", name_, threads_);
+	auto const builders_ = threads_ / 2;
+	suite_.run(label_, [&]()
+	{
+		ds::MpmcQueue<Node *> queue_(256);
+		size_t index_ = 0;
+		auto   builder_threads_ = ds::Stack<ds::Thread>(builders_, [&]()
+		{
+			auto i = index_++;
+			return ds::Thread({ 0, "ds_builder" }, [&, i](ds::Persistent<ds::Thread *>)
+			{
+				for(size_t n = i; n < total_docs; n += builders_)
+					queue_.push(make_document<A>(0x9e3779b97f4a7c15ULL + n));
+			});
+		});
+		auto freeing_threads_ = ds::Stack<ds::Thread>(threads_ - builders_, [&]()
+		{
+			return ds::Thread({ 0, "ds_freer" }, [&](ds::Persistent<ds::Thread *>)
+			{
+				uint64_t local_ = 0;
+				Node   * root_;
+				while(queue_.pop(root_))
+					local_ += destroy_document<A>(root_);
+				sum_.fetch_add(local_, std::memory_order_relaxed);
+			});
+		});
+		for(auto & thread_ : builder_threads_)
+			thread_.join();
+		queue_.close();
+		for(auto & thread_ : freeing_threads_)
+			thread_.join();
+	}, { 0, double(total_docs) });
+	printf("  checksum %llu\n", (unsigned long long)sum_.load());
+}
+
+int main()
+{
+	ds::BenchmarkOptions options_;
+	options_.samples     = samples;
+	options_.min_samples = samples;
+	options_.warmup_time = 0;
+	ds::Benchmark suite_ { "thread_caching_allocator", options_ };
+	printf("-- %zu documents of %zu nodes\n", total_docs, doc_nodes);
+	for(size_t threads_ = 1; threads_ <= thread_max; threads_ *= 2)
+	{
+		printf("-- %zu threads\n", threads_);
+		own_documents<ds::DefaultAllocator>(suite_, "DefaultAllocator", threads_);
+		own_documents<ds::ThreadCachingAllocator>(suite_, "ThreadCaching", threads_);
+		if(threads_ < 2)
+			continue;
+		handed_documents<ds::DefaultAllocator>(suite_, "DefaultAllocator", threads_);
+		handed_documents<ds::ThreadCachingAllocator>(suite_, "ThreadCaching", threads_);
+	}
+}
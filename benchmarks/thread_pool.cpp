@@ -0,0 +1,101 @@
+#include <ds/all>
+#include <ds/thread>
+#include <ds/thread_pool>
+#include <ds/benchmark>
+
+// ds::ThreadPool task throughput: empty tasks submitted from outside the pool,
+// a task tree spawned from inside it, against one ds::Thread per task, and
+// parallel_for/parallel_reduce over a large array. An iteration runs every task
+// or passes over the array once.
+
+static constexpr size_t samples     = 5;
+static constexpr size_t task_count  = 1000000;
+static constexpr size_t array_size  = 1 << 24;
+
+// each task spawns two more until depth_ runs out
+static void
+spawn_tree(ds::ThreadPool & pool_, ds::WaitGroup & group_, size_t depth_)
+{
+	if(depth_ == 0)
+		return;
+	pool_.submit(group_, [&pool_, &group_, depth_]() { spawn_tree(pool_, group_, depth_ - 1); });
+	pool_.submit(group_, [&pool_, &group_, depth_]() { spawn_tree(pool_, group_, depth_ - 1); });
+}
+
+static void
+run(ds::Benchmark & suite_, size_t threads_, ds::array<uint32_t> & data_)
+{
+	char label_[64];
+	ds::ThreadPool pool_(threads_);
+	printf("-- %zu threads\n", pool_.thread_count());
+	{
+		std::atomic<size_t> counter_ { 0 };
+		snprintf(label_, sizeof(label_), "submit %zu tasks", task_count);
+		suite_.run(label_, [&]()
+		{
+			ds::WaitGroup group_;
+			for(size_t i = 0; i < task_count; ++i)
+				pool_.submit(group_, [&counter_]() { counter_.fetch_add(1, std::memory_order_relaxed); });
+			pool_.wait(group_);
+		}, { 0, double(task_count) });
+	}
+	{
+		// 2^20 - 2 tasks
+		suite_.run("spawn tree depth 19", [&]()
+		{
+			ds::WaitGroup group_;
+			spawn_tree(pool_, group_, 19);
+			pool_.wait(group_);
+		}, { 0, double((size_t(1) << 20) - 2) });
+	}
+	{
+		suite_.run("parallel_for", [&]()
+		{
+			pool_.parallel_for(0, data_.size(), [&data_](size_t begin_, size_t end_)
+			{
+				for(size_t i = begin_; i < end_; ++i)
+					data_[i] = data_[i] * 2654435761u + 1;
+			});
+		}, { double(array_size * sizeof(uint32_t)), double(array_size) });
+	}
+	{
+		uint64_t sum_ = 0;
+		suite_.run("parallel_reduce", [&]()
+		{
+			sum_ = pool_.parallel_reduce(0, data_.size(), uint64_t(0), [&data_](size_t begin_, size_t end_)
+			{
+				uint64_t partial_ = 0;
+				for(size_t i = begin_; i < end_; ++i)
+					partial_ += data_[i];
+				return partial_;
+			}, [](uint64_t a, uint64_t b) { return a + b; });
+		}, { double(array_size * sizeof(uint32_t)), double(array_size) });
+		printf("  checksum %llu\n", (unsigned long long)sum_);
+	}
+}
+
+int main()
+{
+	ds::BenchmarkOptions options_;
+	options_.samples     = samples;
+	options_.min_samples = samples;
+	ds::Benchmark suite_ { "thread_pool", options_ };
+	auto data_ = ds::array<uint32_t>(array_size, uint32_t(1));
+	{
+		// the baseline the pool replaces
+		std::atomic<size_t> counter_ { 0 };
+		suite_.run("ds::Thread per task x 1000", [&]()
+		{
+			for(size_t i = 0; i < 1000; ++i)
+			{
+				ds::Thread thread_({ 0, "ds_task" }, [&counter_](ds::Persistent<ds::Thread *>)
+				{
+					counter_.fetch_add(1, std::memory_order_relaxed);
+				});
+				thread_.join();
+			}
+		}, { 0, 1000 });
+	}
+	for(size_t threads_ = 1; threads_ <= ds::sys::nprocessors(); threads_ *= 2)
+		run(suite_, threads_, data_);
+}
@@ -125,6 +125,7 @@ make_unique(Args &&... args) axl_except
 
 static constexpr char_t    hex_char(uint8_t value);
 static constexpr uint8_t hex_value(char_t hex_char);
+static bool equal(Variant const & lhs, Variant const & rhs) axl_noexcept;
 
 struct Null
 {
@@ -289,6 +290,7 @@ struct String
 struct Array
 {
 	unique_ptr_t<array_t<variant_t>> m_elements {};
+	mutable hash_t                   m_hash     {}; // cached content hash, 0 while not computed
 	
 	~Array() = default;
 	Array() = default;
@@ -336,6 +338,7 @@ struct Entry;
 struct Object
 {
 	unique_ptr_t<object_t<variant_t>> m_entries {};
+	mutable hash_t                    m_hash    {}; // cached content hash, 0 while not computed
 	
 	~Object() = default;
 	Object() axl_noexcept;
@@ -649,7 +652,7 @@ struct Variant
 		return this->operator!=(Variant(rhs));
 	}
 
-	constexpr bool 
+	bool 
 	operator==(Variant const & rhs) const axl_noexcept 
 	{
 		if(rhs.index != index)
@@ -661,14 +664,14 @@ struct Variant
 			case integer_i: return integer.m_value  == rhs.integer.m_value;
 			case number_i:  return number.m_value   == rhs.number.m_value;
 			case string_i:  return string.m_value   == rhs.string.m_value || ((string.m_value && rhs.string.m_value) && *(string.m_value.ptr()) == *(rhs.string.m_value.ptr()));
-			case array_i:   return array.m_elements == rhs.array.m_elements;
-			case object_i:  return object.m_entries == rhs.object.m_entries;
+			case array_i:   
+			case object_i:  return equal(*this, rhs);
 			default: 
 			case invalid_i: return false;
 		} 
 	}
 
-	constexpr bool 
+	bool 
 	operator!=(Variant const & rhs) const axl_noexcept 
 	{
 		if(rhs.index != index)
@@ -680,8 +683,8 @@ struct Variant
 			case integer_i: return integer.m_value  != rhs.integer.m_value;
 			case number_i:  return number.m_value   != rhs.number.m_value;
 			case string_i:  return string.m_value   != rhs.string.m_value || ((string.m_value && rhs.string.m_value) && *(string.m_value.ptr()) != *(rhs.string.m_value.ptr())) || (bool(string.m_value) == !rhs.string.m_value);
-			case array_i:   return array.m_elements != rhs.array.m_elements;
-			case object_i:  return object.m_entries != rhs.object.m_entries;
+			case array_i:   
+			case object_i:  return !equal(*this, rhs);
 			default: 
 			case invalid_i: return true;
 		} 
@@ -698,10 +701,12 @@ struct Variant
 
 Array::Array(Array && rhs) 
 	: m_elements { axl::move(rhs.m_elements) }
+	, m_hash     { rhs.m_hash }
 {}
 
 Array::Array(Array const & rhs) 
 	: m_elements { rhs.m_elements ? make_unique<array_t<variant_t>>(*rhs.m_elements) : unique_ptr_t<array_t<variant_t>>{} }
+	, m_hash     { rhs.m_hash }
 {}
 
 template <size_t size_>
@@ -714,6 +719,7 @@ array_iterator_t<variant_t>
 Array::insert(Args &&... args)
 {
 	axl_throw_if(!m_elements, axl::null_pointer_exception("json::Array::insert(): uninitialized elements"));
+	m_hash = 0;
 	auto & elements = *m_elements.ptr();
 	return elements.emplace(axl::forward<Args>(args)...);
 }
@@ -723,13 +729,17 @@ array_iterator_t<variant_t>
 Array::rinsert(Args &&... args)
 {
 	axl_throw_if(!m_elements, axl::null_pointer_exception("json::Array::insert(): uninitialized elements"));
+	m_hash = 0;
 	auto & elements = *m_elements.ptr();
 	return elements.remplace(axl::forward<Args>(args)...);
 }
 
 array_t<variant_t> & 
 Array::elements() axl_except
-{ return *m_elements; }
+{ 
+	m_hash = 0;
+	return *m_elements; 
+}
 
 array_t<variant_t> const & 
 Array::elements() const axl_except
@@ -739,10 +749,11 @@ variant_t &
 Array::operator[](size_t index) axl_except
 {
 	axl_throw_if(!m_elements, axl::null_pointer_exception("json::Array::operator[]"));
+	m_hash = 0;
 	auto & elements_ = *m_elements.ptr();
 	auto it = elements_.begin();
 	axl_throw_if(index >= elements_.size(), axl::index_out_of_bounds_exception("json::Array::operator[]", index, elements_.size()));
-	for(; index > 0 && it; ++it);
+	for(; index > 0 && it; ++it, --index);
 	return *it;
 }
 
@@ -753,11 +764,11 @@ Array::operator[](size_t index) const axl_except
 	auto const & elements_ = *m_elements.ptr();
 	auto it = elements_.begin();
 	axl_throw_if(index >= elements_.size(), axl::index_out_of_bounds_exception("json::Array::operator[]", index, elements_.size()));
-	for(; index > 0 && it; ++it);
+	for(; index > 0 && it; ++it, --index);
 	return *it;
 }
 
-Array::operator unique_ptr_t<array_t<variant_t>>       & ()       axl_noexcept { return m_elements; }
+Array::operator unique_ptr_t<array_t<variant_t>>       & ()       axl_noexcept { m_hash = 0; return m_elements; }
 Array::operator unique_ptr_t<array_t<variant_t>> const & () const axl_noexcept { return m_elements; }
 
 bool Array::operator!()       axl_noexcept { return !m_elements; }
@@ -786,10 +797,12 @@ Object::Object() axl_noexcept
 
 Object::Object(Object && rhs) axl_noexcept 
 	: m_entries { axl::move(rhs.m_entries) }
+	, m_hash    { rhs.m_hash }
 {}
 
 Object::Object(Object const & rhs) 
 	: m_entries { rhs.m_entries ? make_unique<object_t<variant_t>>(*rhs.m_entries) : unique_ptr_t<object_t<variant_t>>{} }
+	, m_hash    { rhs.m_hash }
 {}
 
 template <size_t size_>
@@ -799,7 +812,10 @@ Object::Object(Entry (&& entries_)[size_])
 
 object_t<variant_t> & 
 Object::entries() axl_except
-{ return *m_entries; }
+{ 
+	m_hash = 0;
+	return *m_entries; 
+}
 
 object_t<variant_t> const & 
 Object::entries() const axl_except
@@ -809,6 +825,7 @@ bool
 Object::set(string_view_t const & key_, variant_t && value_) axl_except
 {
 	axl_throw_if(!m_entries, axl::null_pointer_exception("json::Object::set(): uninitialized entries"));
+	m_hash = 0;
 	auto & entries_ = *m_entries.ptr();
 	entries_.emplace(key_, axl::move(value_));
 	return false;
@@ -818,6 +835,7 @@ bool
 Object::set(string_view_t const & key_, variant_t const & value_) axl_except
 {
 	axl_throw_if(!m_entries, axl::null_pointer_exception("json::Object::set(): uninitialized entries"));
+	m_hash = 0;
 	auto & entries_ = *m_entries.ptr();
 	entries_.emplace(key_, value_);
 	return false;
@@ -827,6 +845,7 @@ bool
 Object::set(String && key_, variant_t && value_) axl_except
 {
 	axl_throw_if(!m_entries, axl::null_pointer_exception("json::Object::set(): uninitialized entries"));
+	m_hash = 0;
 	auto & entries_ = *m_entries.ptr();
 	entries_.emplace(axl::move(key_.value()), axl::move(value_));
 	return false;
@@ -836,6 +855,7 @@ bool
 Object::set(String && key_, variant_t const & value_) axl_except
 {
 	axl_throw_if(!m_entries, axl::null_pointer_exception("json::Object::set(): uninitialized entries"));
+	m_hash = 0;
 	auto & entries_ = *m_entries.ptr();
 	entries_.emplace(axl::move(key_.value()), value_);
 	return false;
@@ -845,6 +865,7 @@ bool
 Object::set(String const & key_, variant_t && value_) axl_except
 {
 	axl_throw_if(!m_entries, axl::null_pointer_exception("json::Object::set(): uninitialized entries"));
+	m_hash = 0;
 	auto & entries_ = *m_entries.ptr();
 	entries_.emplace(key_.value(), axl::move(value_));
 	return false;
@@ -854,6 +875,7 @@ bool
 Object::set(String const & key_, variant_t const & value_) axl_except
 {
 	axl_throw_if(!m_entries, axl::null_pointer_exception("json::Object::set(): uninitialized entries"));
+	m_hash = 0;
 	auto & entries_ = *m_entries.ptr();
 	entries_.emplace(key_.value(), value_);
 	return false;
@@ -865,6 +887,7 @@ Object::remove(string_view_t const & key) axl_noexcept
 {
 	if(!m_entries)
 		return false;
+	m_hash = 0;
 	return (*m_entries.ptr()).remove(key);
 }
 
@@ -1003,6 +1026,7 @@ variant_t &
 Object::operator[](string_view_t const & key) axl_except
 {
 	axl_throw_if(!m_entries, axl::null_pointer_exception("json::Object::operator[]"));
+	m_hash = 0;
 	return (*m_entries)[key];
 }
 
@@ -1013,7 +1037,7 @@ Object::operator[](string_view_t const & key) const axl_except
 	return (*m_entries)[key];
 }
 
-Object::operator unique_ptr_t<object_t<variant_t>>       & ()       axl_noexcept { return m_entries; }
+Object::operator unique_ptr_t<object_t<variant_t>>       & ()       axl_noexcept { m_hash = 0; return m_entries; }
 Object::operator unique_ptr_t<object_t<variant_t>> const & () const axl_noexcept { return m_entries; }
 
 bool Object::operator!()       axl_noexcept { return !m_entries; }
@@ -1534,7 +1558,8 @@ parse_numeric(axl::stream::Input & istream, Variant & rhs, char_t ch_)
 	{
 		case '.':
 			point_  = true;
-			break;
+			just_read_point_ = true;
+			goto read_digits;
 		case '-':
 		case '+':
 			signed_ = true;
@@ -1630,7 +1655,7 @@ parse_numeric(axl::stream::Input & istream, Variant & rhs, char_t ch_)
 						buffer[i++] = ch;
 						if(just_read_point_ && ch != '.')
 							just_read_point_ = false;
-						if(just_read_exponent_ && ch != 'e')
+						if(just_read_exponent_ && ch != 'e' && ch != 'E')
 							just_read_exponent_ = false;
 						continue;
 					}
@@ -1714,11 +1739,26 @@ parse(axl::stream::Input & istream, String & rhs, char_t ch_)
 		jstr = axl::move(jstr_);
 		i = 0;
 	};
+	// a high surrogate is held back until the escape after it shows whether it is paired
+	uint16_t surrogate_ = 0;
+	auto flush_surrogate = [&]()
+	{
+		if(surrogate_ == 0)
+			return;
+		if(i >= buffer_size_ - 3)
+			flush_buffer();
+		buffer[i++] = char_t(0xE0 | ((surrogate_ >> 12) & 0x0F));
+		buffer[i++] = char_t(0x80 | ((surrogate_ >> 6) & 0x3F));
+		buffer[i++] = char_t(0x80 | (surrogate_ & 0x3F));
+		surrogate_ = 0;
+	};
 	bool escape_ = false;
 	while(1 == (read_ = istream.read(&ch, sizeof(char_t), 1)))
 	{
 		if(process_string)
 		{
+			if(escape_ ? ch != 'u' : ch != '\\')
+				flush_surrogate();
 			switch(ch)
 			{
 				case '"':
@@ -1754,12 +1794,20 @@ parse(axl::stream::Input & istream, String & rhs, char_t ch_)
 								if(N != (read_ = istream.read(&ucode[0], sizeof(char_t), N)))
 									goto end_loop;
 								read_ = 1;
-								uint16_t unicode_ = 
-									  uint16_t(hex_value(ucode[0])) << 12
-									| uint16_t(hex_value(ucode[1])) << 8
-									| uint16_t(hex_value(ucode[2])) << 4
-									| uint16_t(hex_value(ucode[3]));
-								if(unicode_ <= 0x007F)
+								uint32_t unicode_ = 
+									  uint32_t(hex_value(ucode[0])) << 12
+									| uint32_t(hex_value(ucode[1])) << 8
+									| uint32_t(hex_value(ucode[2])) << 4
+									| uint32_t(hex_value(ucode[3]));
+								if(surrogate_ != 0 && unicode_ >= 0xDC00 && unicode_ <= 0xDFFF)
+								{
+									unicode_ = 0x10000 + ((uint32_t(surrogate_) - 0xD800) << 10) + (unicode_ - 0xDC00);
+									surrogate_ = 0;
+								}
+								flush_surrogate();
+								if(unicode_ >= 0xD800 && unicode_ <= 0xDBFF)
+									surrogate_ = uint16_t(unicode_);
+								else if(unicode_ <= 0x007F)
 								{
 									if(i >= buffer_size_)
 										flush_buffer();
@@ -1782,14 +1830,12 @@ parse(axl::stream::Input & istream, String & rhs, char_t ch_)
 								}
 								else
 								{
-									if(i >= buffer_size_ - 6)
+									if(i >= buffer_size_ - 4)
 										flush_buffer();
-									buffer[i++] = '\\';
-									buffer[i++] = 'u';
-									buffer[i++] = ucode[0];
-									buffer[i++] = ucode[1];
-									buffer[i++] = ucode[2];
-									buffer[i++] = ucode[3];
+									buffer[i++] = char_t(0xF0 | ((unicode_ >> 18) & 0x07));
+									buffer[i++] = char_t(0x80 | ((unicode_ >> 12) & 0x3F));
+									buffer[i++] = char_t(0x80 | ((unicode_ >> 6) & 0x3F));
+									buffer[i++] = char_t(0x80 | (unicode_ & 0x3F));
 								}
 							}
 							else
@@ -2064,6 +2110,1318 @@ hex_value(char_t hex_char)
 		return 0;
 }
 
+
+/// Content hashing
+// Arrays and objects cache their hash (Merkle-style, bottom-up) in `m_hash` on first use.
+// Every non-const accessor of Array/Object resets it, and a nested value can only be reached
+// for mutation through the non-const accessors of all of its parents, so changing a value
+// deep in the tree dirties the whole path up to the root and an unchanged subtree keeps its
+// hash. A reference obtained from a non-const accessor dirties only at the time it is taken:
+// after a hash of the document it has to be fetched again before the value is changed.
+// The cache is read and written with relaxed atomics, so several threads may hash the same
+// const document. Hash equality is only a hint, never a proof.
+
+static constexpr uint64_t _hash_seed_invalid = 0x6A09E667F3BCC908ull;
+static constexpr uint64_t _hash_seed_null    = 0xBB67AE8584CAA73Bull;
+static constexpr uint64_t _hash_seed_boolean = 0x3C6EF372FE94F82Bull;
+static constexpr uint64_t _hash_seed_integer = 0xA54FF53A5F1D36F1ull;
+static constexpr uint64_t _hash_seed_number  = 0x510E527FADE682D1ull;
+static constexpr uint64_t _hash_seed_string  = 0x9B05688C2B3E6C1Full;
+static constexpr uint64_t _hash_seed_array   = 0x1F83D9ABFB41BD6Bull;
+static constexpr uint64_t _hash_seed_object  = 0x5BE0CD19137E2179ull;
+
+static hash_t content_hash(Variant const & rhs) axl_noexcept;
+static hash_t content_hash(Array const & rhs) axl_noexcept;
+static hash_t content_hash(Object const & rhs) axl_noexcept;
+
+static inline uint64_t
+_hash_mix(uint64_t value_) axl_noexcept
+{
+	value_ ^= value_ >> 30;
+	value_ *= 0xBF58476D1CE4E5B9ull;
+	value_ ^= value_ >> 27;
+	value_ *= 0x94D049BB133111EBull;
+	value_ ^= value_ >> 31;
+	return value_;
+}
+
+static inline uint64_t
+_hash_combine(uint64_t seed_, uint64_t value_) axl_noexcept
+{
+	return _hash_mix(seed_ ^ (value_ + 0x9E3779B97F4A7C15ull + (seed_ << 6) + (seed_ >> 2)));
+}
+
+static inline uint64_t
+_hash_bytes(char_t const * begin_, size_t length_) axl_noexcept
+{
+	uint64_t hash_ = 0xCBF29CE484222325ull;
+	for(size_t i = 0; i < length_; ++i)
+	{
+		hash_ ^= uint64_t(uint8_t(begin_[i]));
+		hash_ *= 0x100000001B3ull;
+	}
+	return _hash_mix(hash_ ^ uint64_t(length_));
+}
+
+// never returns 0, which marks a stale cache
+static inline hash_t
+_hash_finish(uint64_t value_) axl_noexcept
+{
+	hash_t hash_ = static_cast<hash_t>(value_ ^ (value_ >> 32));
+	return hash_ == 0 ? 1 : hash_;
+}
+
+static inline hash_t
+_cached_hash(hash_t const & cache_) axl_noexcept
+{
+	return __atomic_load_n(&cache_, __ATOMIC_RELAXED);
+}
+
+static inline hash_t
+_cache_hash(hash_t & cache_, hash_t hash_) axl_noexcept
+{
+	__atomic_store_n(&cache_, hash_, __ATOMIC_RELAXED);
+	return hash_;
+}
+
+static inline hash_t
+content_hash(String const & rhs) axl_noexcept
+{
+	if(!rhs)
+		return _hash_finish(_hash_combine(_hash_seed_string, 0));
+	auto const & str_ = rhs.value();
+	return _hash_finish(_hash_combine(_hash_seed_string, _hash_bytes(str_.begin(), str_.length())));
+}
+
+static hash_t
+content_hash(Array const & rhs) axl_noexcept
+{
+	if(!rhs.m_elements)
+		return _hash_finish(_hash_combine(_hash_seed_array, 0));
+	if(auto cached_ = _cached_hash(rhs.m_hash))
+		return cached_;
+	auto const & elements_ = *rhs.m_elements.ptr();
+	uint64_t hash_ = _hash_seed_array;
+	for(auto it = elements_.begin(); it; ++it)
+		hash_ = _hash_combine(hash_, content_hash(*it.ptr()));
+	return _cache_hash(rhs.m_hash, _hash_finish(_hash_combine(hash_, elements_.size())));
+}
+
+static hash_t
+content_hash(Object const & rhs) axl_noexcept
+{
+	if(!rhs.m_entries)
+		return _hash_finish(_hash_combine(_hash_seed_object, 0));
+	if(auto cached_ = _cached_hash(rhs.m_hash))
+		return cached_;
+	auto const & entries_ = *rhs.m_entries.ptr();
+	// entries are summed so that the hash does not depend on the iteration order
+	uint64_t sum_ = 0;
+	for(auto it = entries_.begin(); it; ++it)
+	{
+		auto const & key_ = it.ptr()->key();
+		sum_ += _hash_combine(_hash_bytes(key_.begin(), key_.length()), content_hash(it.ptr()->value()));
+	}
+	return _cache_hash(rhs.m_hash, _hash_finish(_hash_combine(_hash_combine(_hash_seed_object, sum_), entries_.size())));
+}
+
+static hash_t
+content_hash(Variant const & rhs) axl_noexcept
+{
+	switch(rhs.index)
+	{
+		case rhs.null_i:    return _hash_finish(_hash_seed_null);
+		case rhs.boolean_i: return _hash_finish(_hash_combine(_hash_seed_boolean, rhs.boolean.value() ? 1 : 0));
+		case rhs.integer_i: return _hash_finish(_hash_combine(_hash_seed_integer, static_cast<uint64_t>(rhs.integer.value())));
+		case rhs.number_i:  
+		{
+			auto const & value_ = rhs.number.value();
+			uint64_t bits_ = 0; // +0.0 == -0.0
+			if(value_ != 0)
+				__builtin_memcpy(&bits_, &value_, sizeof(bits_));
+			return _hash_finish(_hash_combine(_hash_seed_number, bits_));
+		}
+		case rhs.string_i:  return content_hash(rhs.string);
+		case rhs.array_i:   return content_hash(rhs.array);
+		case rhs.object_i:  return content_hash(rhs.object);
+		case rhs.invalid_i:
+		default: return _hash_finish(_hash_seed_invalid);
+	}
+}
+
+static inline size_t
+_size(Array const & rhs) axl_noexcept
+{
+	return rhs.m_elements ? rhs.m_elements.ptr()->size() : 0;
+}
+
+static inline size_t
+_size(Object const & rhs) axl_noexcept
+{
+	return rhs.m_entries ? rhs.m_entries.ptr()->size() : 0;
+}
+
+static inline string_view_t
+_view(heap_string_t const & rhs) axl_noexcept
+{
+	return string_view_t(rhs.begin(), rhs.begin() + rhs.length());
+}
+
+static inline Variant const *
+_member(Object const & object_, string_view_t const & key_) axl_noexcept
+{
+	if(!object_.m_entries)
+		return nullptr;
+	auto it = object_.m_entries.ptr()->position_of(key_);
+	return it ? &it.ptr()->value() : nullptr;
+}
+
+static inline Variant *
+_member(Object & object_, string_view_t const & key_) axl_noexcept
+{
+	if(!object_.m_entries)
+		return nullptr;
+	auto it = object_.entries().position_of(key_);
+	return it ? &it.ptr()->value() : nullptr;
+}
+
+// structural equality, stops at the first differing element or member. composites with
+// different hashes are rejected without a walk once their hashes are cached.
+static bool
+equal(Variant const & lhs, Variant const & rhs) axl_noexcept
+{
+	if(&lhs == &rhs)
+		return true;
+	if(lhs.index != rhs.index)
+		return false;
+	switch(lhs.index)
+	{
+		case Variant::array_i:
+		{
+			if(_size(lhs.array) != _size(rhs.array) || content_hash(lhs.array) != content_hash(rhs.array))
+				return false;
+			if(_size(lhs.array) == 0)
+				return true;
+			auto it = lhs.array.elements().begin();
+			auto jt = rhs.array.elements().begin();
+			for(; it && jt; ++it, ++jt)
+				if(!equal(*it.ptr(), *jt.ptr()))
+					return false;
+			return true;
+		}
+		case Variant::object_i:
+		{
+			if(_size(lhs.object) != _size(rhs.object) || content_hash(lhs.object) != content_hash(rhs.object))
+				return false;
+			if(_size(lhs.object) == 0)
+				return true;
+			for(auto it = lhs.object.entries().begin(); it; ++it)
+			{
+				auto const * value_ = _member(rhs.object, _view(it.ptr()->key()));
+				if(!value_ || !equal(it.ptr()->value(), *value_))
+					return false;
+			}
+			return true;
+		}
+		default:
+			return lhs == rhs;
+	}
+}
+
+/// JSON pointer (RFC 6901) helpers
+
+// `m_string` grows geometrically; its first `m_length` characters are used
+struct _StringBuilder
+{
+	static constexpr size_t buffer_size_ = 256;
+	heap_string_t m_string {};
+	size_t        m_length = 0;
+	char_t        m_buffer[buffer_size_] {};
+	size_t        m_i = 0;
+
+	void
+	flush()
+	{
+		if(m_i == 0)
+			return;
+		if(m_length + m_i > m_string.length())
+		{
+			size_t capacity_ = m_string.length() * 2;
+			if(capacity_ < m_length + m_i)
+				capacity_ = m_length + m_i;
+			heap_string_t string_(capacity_);
+			if(m_length > 0)
+				string_.copy(m_string, 0, m_length);
+			m_string = axl::move(string_);
+		}
+		m_string.copy(string_view_t(&m_buffer[0], &m_buffer[m_i]), m_length, m_i);
+		m_length += m_i;
+		m_i = 0;
+	}
+
+	void
+	clear()
+	{
+		m_string = heap_string_t();
+		m_length = 0;
+		m_i      = 0;
+	}
+
+	_StringBuilder &
+	append(char_t ch)
+	{
+		if(m_i >= buffer_size_)
+			flush();
+		m_buffer[m_i++] = ch;
+		return *this;
+	}
+
+	_StringBuilder &
+	append(char_t const * begin_, char_t const * end_)
+	{
+		for(; begin_ != end_; ++begin_)
+			append(*begin_);
+		return *this;
+	}
+
+	// appends `/token` with `~` and `/` escaped as `~0` and `~1`
+	_StringBuilder &
+	append_token(char_t const * begin_, char_t const * end_)
+	{
+		append('/');
+		for(; begin_ != end_; ++begin_)
+		{
+			switch(*begin_)
+			{
+				case '~': append('~').append('0'); break;
+				case '/': append('~').append('1'); break;
+				default:  append(*begin_); break;
+			}
+		}
+		return *this;
+	}
+
+	_StringBuilder &
+	append_index(size_t index_)
+	{
+		char_t digits_[24] {};
+		size_t i = sizeof(digits_) / sizeof(char_t);
+		do
+		{
+			digits_[--i] = char_t('0' + (index_ % 10));
+			index_ /= 10;
+		}
+		while(index_ > 0);
+		append('/');
+		return append(&digits_[i], &digits_[sizeof(digits_) / sizeof(char_t)]);
+	}
+
+	heap_string_t &
+	string()
+	{
+		flush();
+		if(m_length != m_string.length())
+		{
+			heap_string_t string_(m_length);
+			if(m_length > 0)
+				string_.copy(m_string, 0, m_length);
+			m_string = axl::move(string_);
+		}
+		return m_string;
+	}
+};
+
+static inline heap_string_t
+_child_path(heap_string_t const & path_, heap_string_t const & key_)
+{
+	_StringBuilder builder_;
+	builder_.append(path_.begin(), path_.begin() + path_.length());
+	builder_.append_token(key_.begin(), key_.begin() + key_.length());
+	return axl::move(builder_.string());
+}
+
+static inline heap_string_t
+_child_path(heap_string_t const & path_, size_t index_)
+{
+	_StringBuilder builder_;
+	builder_.append(path_.begin(), path_.begin() + path_.length());
+	builder_.append_index(index_);
+	return axl::move(builder_.string());
+}
+
+// reads the reference token starting at `pos_` (just after its `/`) and unescapes it
+static inline heap_string_t
+_pointer_token(string_view_t const & pointer_, size_t & pos_) axl_except
+{
+	_StringBuilder builder_;
+	char_t const * begin_ = pointer_.begin();
+	size_t length_ = pointer_.length();
+	for(; pos_ < length_ && begin_[pos_] != '/'; ++pos_)
+	{
+		if(begin_[pos_] == '~')
+		{
+			axl_throw_if(pos_ + 1 >= length_, axl::runtime_error_exception("json::patch(): invalid `~` escape in pointer"));
+			switch(begin_[++pos_])
+			{
+				case '0': builder_.append('~'); break;
+				case '1': builder_.append('/'); break;
+				default:
+					axl_throw(axl::runtime_error_exception("json::patch(): invalid `~` escape in pointer"));
+					break;
+			}
+		}
+		else
+			builder_.append(begin_[pos_]);
+	}
+	return axl::move(builder_.string());
+}
+
+// `-` yields `end_`, the one-past-the-end index
+static inline size_t
+_pointer_index(heap_string_t const & token_, size_t end_) axl_except
+{
+	size_t length_ = token_.length();
+	char_t const * begin_ = token_.begin();
+	if(length_ == 1 && begin_[0] == '-')
+		return end_;
+	axl_throw_if(length_ == 0 || (length_ > 1 && begin_[0] == '0'), axl::runtime_error_exception("json::patch(): invalid array index"));
+	size_t index_ = 0;
+	for(size_t i = 0; i < length_; ++i)
+	{
+		axl_throw_if(begin_[i] < '0' || begin_[i] > '9', axl::runtime_error_exception("json::patch(): invalid array index"));
+		index_ = index_ * 10 + size_t(begin_[i] - '0');
+	}
+	return index_;
+}
+
+static inline Variant *
+_element(Array & array_, size_t index_) axl_noexcept
+{
+	if(index_ >= _size(array_))
+		return nullptr;
+	auto it = array_.elements().begin();
+	for(; index_ > 0 && it; --index_, ++it);
+	return it ? it.ptr() : nullptr;
+}
+
+static inline void
+_append(Array & array_, Variant && value_)
+{
+	if(!array_)
+		array_ = {{ axl::move(value_) }};
+	else
+		array_.insert(axl::move(value_));
+}
+
+// rebuilds `array_` with `value_` inserted before `index_`, or with `index_` removed if `value_` is null
+static void
+_splice(Array & array_, size_t index_, Variant * value_)
+{
+	Array result_;
+	size_t i = 0;
+	if(array_)
+	{
+		for(auto it = array_.elements().begin(); it; ++it, ++i)
+		{
+			if(i == index_)
+			{
+				if(!value_)
+					continue;
+				_append(result_, axl::move(*value_));
+			}
+			_append(result_, axl::move(*it.ptr()));
+		}
+	}
+	if(value_ && i == index_)
+		_append(result_, axl::move(*value_));
+	array_ = axl::move(result_);
+}
+
+static inline void
+_put(Object & object_, string_view_t const & key_, Variant && value_)
+{
+	if(!object_)
+		object_ = Object({ Entry{ key_, axl::move(value_) } });
+	else
+	{
+		object_.remove(key_);
+		object_.set(key_, axl::move(value_));
+	}
+}
+
+/// JSON patch (RFC 6902)
+
+static void
+_diff(Array & operations, Variant const & source, Variant const & target, heap_string_t const & path_);
+
+static inline void
+_push_operation(Array & operations, char_t const * op_, heap_string_t const & path_, Variant const * value_ = nullptr)
+{
+	if(value_)
+		_append(operations, Object({ Entry{ "op", op_ }, Entry{ "path", _view(path_) }, Entry{ "value", *value_ } }));
+	else
+		_append(operations, Object({ Entry{ "op", op_ }, Entry{ "path", _view(path_) } }));
+}
+
+static void
+_diff_objects(Array & operations, Object const & source, Object const & target, heap_string_t const & path_)
+{
+	if(_size(source) > 0)
+	{
+		for(auto it = source.entries().begin(); it; ++it)
+			if(!_member(target, _view(it.ptr()->key())))
+				_push_operation(operations, "remove", _child_path(path_, it.ptr()->key()));
+	}
+	if(_size(target) > 0)
+	{
+		for(auto it = target.entries().begin(); it; ++it)
+		{
+			auto const & key_   = it.ptr()->key();
+			auto const & value_ = it.ptr()->value();
+			auto const * source_value_ = _member(source, _view(key_));
+			if(!source_value_)
+				_push_operation(operations, "add", _child_path(path_, key_), &value_);
+			else
+				_diff(operations, *source_value_, value_, _child_path(path_, key_));
+		}
+	}
+}
+
+// equal common prefix and suffix are skipped, the middle is diffed pairwise and the rest
+// is removed (back to front) or added (front to back) so that every emitted index is valid
+// at the point it is applied
+static void
+_diff_arrays(Array & operations, Array const & source, Array const & target, heap_string_t const & path_)
+{
+	size_t n = _size(source);
+	size_t m = _size(target);
+	if(n == 0 && m == 0)
+		return;
+	if(n == 0 || m == 0)
+	{
+		Variant target_ { target };
+		_push_operation(operations, "replace", path_, &target_);
+		return;
+	}
+	auto const & source_elements = source.elements();
+	auto const & target_elements = target.elements();
+	size_t prefix_ = 0;
+	auto it = source_elements.begin();
+	auto jt = target_elements.begin();
+	for(; prefix_ < n && prefix_ < m && equal(*it.ptr(), *jt.ptr()); ++prefix_, ++it, ++jt);
+	size_t suffix_ = 0;
+	auto rit = source_elements.rbegin();
+	auto rjt = target_elements.rbegin();
+	for(; suffix_ < n - prefix_ && suffix_ < m - prefix_ && equal(*rit.ptr(), *rjt.ptr()); ++suffix_, --rit, --rjt);
+	size_t source_middle_ = n - prefix_ - suffix_;
+	size_t target_middle_ = m - prefix_ - suffix_;
+	size_t common_ = source_middle_ < target_middle_ ? source_middle_ : target_middle_;
+	size_t index_  = prefix_;
+	for(; index_ < prefix_ + common_; ++index_, ++it, ++jt)
+		_diff(operations, *it.ptr(), *jt.ptr(), _child_path(path_, index_));
+	for(size_t i = n - suffix_; i > index_; --i)
+		_push_operation(operations, "remove", _child_path(path_, i - 1));
+	for(; index_ < m - suffix_; ++index_, ++jt)
+		_push_operation(operations, "add", _child_path(path_, index_), jt.ptr());
+}
+
+static void
+_diff(Array & operations, Variant const & source, Variant const & target, heap_string_t const & path_)
+{
+	// differing hashes reject a changed subtree without a walk, so only the identical
+	// subtrees at the top of the unchanged parts are compared element by element
+	if(&source == &target || equal(source, target))
+		return;
+	if(source.index == target.index)
+	{
+		switch(source.index)
+		{
+			case Variant::object_i: return _diff_objects(operations, source.object, target.object, path_);
+			case Variant::array_i:  return _diff_arrays(operations, source.array, target.array, path_);
+			default: break;
+		}
+	}
+	_push_operation(operations, "replace", path_, &target);
+}
+
+// Returns the RFC 6902 operations that turn `source` into `target`. Identical subtrees produce
+// no operations; subtrees whose cached hashes differ are descended into without a comparison.
+static Array
+diff(Variant const & source, Variant const & target)
+{
+	Array operations;
+	_diff(operations, source, target, heap_string_t());
+	return operations;
+}
+
+// Resolves `pointer_` in `document`. If `last_token_` is given the parent of the referenced
+// value is returned instead and the final reference token is stored in `last_token_`.
+static Variant *
+_resolve(Variant & document, string_view_t const & pointer_, heap_string_t * last_token_ = nullptr) axl_except
+{
+	size_t length_ = pointer_.length();
+	if(length_ == 0)
+		return last_token_ ? nullptr : &document;
+	axl_throw_if(pointer_.begin()[0] != '/', axl::runtime_error_exception("json::patch(): pointer must start with `/`"));
+	Variant * current_ = &document;
+	size_t pos_ = 1;
+	while(true)
+	{
+		heap_string_t token_ = _pointer_token(pointer_, pos_);
+		if(pos_ >= length_ && last_token_)
+		{
+			*last_token_ = axl::move(token_);
+			return current_;
+		}
+		switch(current_->index)
+		{
+			case Variant::object_i: current_ = _member(current_->object, _view(token_)); break;
+			case Variant::array_i:  current_ = _element(current_->array, _pointer_index(token_, _size(current_->array))); break;
+			default: current_ = nullptr; break;
+		}
+		axl_throw_if(!current_, axl::runtime_error_exception("json::patch(): path does not exist"));
+		if(pos_ >= length_)
+			return current_;
+		++pos_; // skip `/`
+	}
+}
+
+static void
+_patch_add(Variant & document, string_view_t const & pointer_, Variant && value_) axl_except
+{
+	heap_string_t key_;
+	Variant * parent_ = _resolve(document, pointer_, &key_);
+	if(!parent_)
+	{
+		document = axl::move(value_);
+		return;
+	}
+	switch(parent_->index)
+	{
+		case Variant::object_i:
+			_put(parent_->object, _view(key_), axl::move(value_));
+			break;
+		case Variant::array_i:
+		{
+			size_t index_ = _pointer_index(key_, _size(parent_->array));
+			axl_throw_if(index_ > _size(parent_->array), axl::runtime_error_exception("json::patch(): array index out of bounds"));
+			_splice(parent_->array, index_, &value_);
+			break;
+		}
+		default:
+			axl_throw(axl::runtime_error_exception("json::patch(): parent is not a container"));
+	}
+}
+
+static void
+_patch_remove(Variant & document, string_view_t const & pointer_) axl_except
+{
+	heap_string_t key_;
+	Variant * parent_ = _resolve(document, pointer_, &key_);
+	axl_throw_if(!parent_, axl::runtime_error_exception("json::patch(): cannot remove the root"));
+	switch(parent_->index)
+	{
+		case Variant::object_i:
+			axl_throw_if(!parent_->object.remove(_view(key_)), axl::runtime_error_exception("json::patch(): path does not exist"));
+			break;
+		case Variant::array_i:
+		{
+			size_t index_ = _pointer_index(key_, _size(parent_->array));
+			axl_throw_if(index_ >= _size(parent_->array), axl::runtime_error_exception("json::patch(): array index out of bounds"));
+			_splice(parent_->array, index_, nullptr);
+			break;
+		}
+		default:
+			axl_throw(axl::runtime_error_exception("json::patch(): parent is not a container"));
+	}
+}
+
+static inline bool
+_is(string_view_t const & view_, char_t const * cstr_) axl_noexcept
+{
+	size_t length_ = view_.length();
+	char_t const * begin_ = view_.begin();
+	size_t i = 0;
+	for(; i < length_ && cstr_[i] != char_t() && begin_[i] == cstr_[i]; ++i);
+	return i == length_ && cstr_[i] == char_t();
+}
+
+// true if the pointer `prefix_` references a proper ancestor of the pointer `pointer_`
+static inline bool
+_is_ancestor(string_view_t const & prefix_, string_view_t const & pointer_) axl_noexcept
+{
+	size_t length_ = prefix_.length();
+	if(pointer_.length() <= length_ || pointer_.begin()[length_] != '/')
+		return false;
+	for(size_t i = 0; i < length_; ++i)
+		if(prefix_.begin()[i] != pointer_.begin()[i])
+			return false;
+	return true;
+}
+
+static inline string_view_t
+_operation_string(Object const & operation_, char_t const * member_) axl_except
+{
+	auto const * value_ = _member(operation_, string_view_t(member_));
+	axl_throw_if(!value_ || value_->index != Variant::string_i || !value_->string, axl::runtime_error_exception("json::patch(): missing or invalid operation member"));
+	return _view(value_->string.value());
+}
+
+static inline Variant const &
+_operation_value(Object const & operation_) axl_except
+{
+	auto const * value_ = _member(operation_, string_view_t("value"));
+	axl_throw_if(!value_, axl::runtime_error_exception("json::patch(): missing operation value"));
+	return *value_;
+}
+
+// Applies RFC 6902 `operations` to `document` in order. Application is not atomic: if an
+// operation fails, the preceding ones remain applied. Patch a copy if that matters.
+static void
+patch(Variant & document, Array const & operations) axl_except
+{
+	if(!operations)
+		return;
+	for(auto it = operations.elements().begin(); it; ++it)
+	{
+		auto const & operation_var_ = *it.ptr();
+		axl_throw_if(operation_var_.index != Variant::object_i, axl::runtime_error_exception("json::patch(): operation is not an object"));
+		auto const & operation_ = operation_var_.object;
+		string_view_t op_   = _operation_string(operation_, "op");
+		string_view_t path_ = _operation_string(operation_, "path");
+		if(_is(op_, "add"))
+			_patch_add(document, path_, Variant(_operation_value(operation_)));
+		else if(_is(op_, "remove"))
+			_patch_remove(document, path_);
+		else if(_is(op_, "replace"))
+			*_resolve(document, path_) = _operation_value(operation_);
+		else if(_is(op_, "move"))
+		{
+			string_view_t from_ = _operation_string(operation_, "from");
+			axl_throw_if(_is_ancestor(from_, path_), axl::runtime_error_exception("json::patch(): cannot move a value into one of its children"));
+			Variant value_ = axl::move(*_resolve(document, from_));
+			_patch_remove(document, from_);
+			_patch_add(document, path_, axl::move(value_));
+		}
+		else if(_is(op_, "copy"))
+			_patch_add(document, path_, Variant(*_resolve(document, _operation_string(operation_, "from"))));
+		else if(_is(op_, "test"))
+			axl_throw_if(!equal(*_resolve(document, path_), _operation_value(operation_)), axl::runtime_error_exception("json::patch(): test failed"));
+		else
+			axl_throw(axl::runtime_error_exception("json::patch(): unknown operation"));
+	}
+}
+
+/// JSON merge patch (RFC 7386)
+
+// Applies the merge `patch_` to `target`.
+static void
+merge_patch(Variant & target, Variant const & patch_)
+{
+	if(patch_.index != Variant::object_i)
+	{
+		target = patch_;
+		return;
+	}
+	if(target.index != Variant::object_i)
+		target = Object();
+	if(_size(patch_.object) == 0)
+		return;
+	for(auto it = patch_.object.entries().begin(); it; ++it)
+	{
+		auto key_ = _view(it.ptr()->key());
+		auto const & value_ = it.ptr()->value();
+		if(value_.index == Variant::null_i)
+			target.object.remove(key_);
+		else if(auto * member_ = _member(target.object, key_))
+			merge_patch(*member_, value_);
+		else
+		{
+			Variant member_value_;
+			merge_patch(member_value_, value_);
+			_put(target.object, key_, axl::move(member_value_));
+		}
+	}
+}
+
+// Returns the merge patch that turns `source` into `target`. Members with equal values
+// are skipped, members whose cached hashes differ are recursed into without a comparison.
+// `null` values inside `target` objects cannot be expressed by a merge patch.
+static Variant
+merge_diff(Variant const & source, Variant const & target)
+{
+	if(source.index != Variant::object_i || target.index != Variant::object_i)
+		return target;
+	Object patch_;
+	if(_size(source.object) > 0)
+	{
+		for(auto it = source.object.entries().begin(); it; ++it)
+		{
+			auto key_ = _view(it.ptr()->key());
+			if(!_member(target.object, key_))
+				_put(patch_, key_, Variant(null));
+		}
+	}
+	if(_size(target.object) > 0)
+	{
+		for(auto it = target.object.entries().begin(); it; ++it)
+		{
+			auto key_ = _view(it.ptr()->key());
+			auto const & value_ = it.ptr()->value();
+			auto const * source_value_ = _member(source.object, key_);
+			if(!source_value_)
+				_put(patch_, key_, Variant(value_));
+			else if(!equal(*source_value_, value_))
+				_put(patch_, key_, merge_diff(*source_value_, value_));
+		}
+	}
+	return Variant(axl::move(patch_));
+}
+
+/// Incremental parser
+
+// Parses JSON text that arrives in arbitrary fragments. Every byte is visited once and the
+// partially built value is kept between calls to `feed()`. Completed top-level values are
+// collected in order and handed out by `take()`. A top-level number is only known to be
+// complete once a delimiter follows it, or when `finish()` is called at the end of input.
+struct Parser
+{
+	enum Status : uint8_t 
+	{
+		  need_more // no completed value is pending
+		, done      // completed values are available through `take()`
+		, error     // invalid input, see `error_message()` and `offset()`
+	};
+
+	enum State : uint8_t 
+	{
+		  value_s   // expecting a value, or `]` if `m_close_ok`
+		, key_s     // expecting an object key, or `}` if `m_close_ok`
+		, colon_s
+		, next_s    // expecting `,` or the closing bracket of the current container
+		, literal_s
+		, number_s
+		, string_s
+		, escape_s
+		, unicode_s
+		, error_s
+	};
+
+	struct Frame
+	{
+		Variant             value;  // the Array or Object under construction
+		heap_string_t       key {}; // the pending key of an object
+		unique_ptr_t<Frame> parent {};
+
+		Frame(Variant && value_, unique_ptr_t<Frame> && parent_)
+			: value  { axl::move(value_) }
+			, parent { axl::move(parent_) }
+		{}
+	};
+
+	static constexpr size_t max_number_size_ = 64;
+
+	Array               m_values   {};
+	unique_ptr_t<Frame> m_top      {};
+	_StringBuilder      m_builder  {};
+	State               m_state    { value_s };
+	bool                m_close_ok = false;
+	bool                m_is_key   = false;
+	bool                m_raw_escape = false;
+	char_t const *      m_literal  = nullptr;
+	size_t              m_literal_i = 0;
+	char_t              m_number[max_number_size_ + 1] {};
+	size_t              m_number_i = 0;
+	bool                m_signed   = false;
+	bool                m_point    = false;
+	bool                m_exponent = false;
+	char_t              m_hex[6]   {};
+	size_t              m_hex_i    = 0;
+	size_t              m_hex_size = 0;
+	uint32_t            m_surrogate = 0; // a high surrogate waiting for the low one of its pair
+	size_t              m_depth    = 0;
+	size_t              m_offset   = 0;
+	char_t const *      m_error    = nullptr;
+
+	Status
+	feed(char_t const * data_, size_t size_)
+	{
+		for(size_t i = 0; i < size_;)
+		{
+			bool consumed_ = _step(data_[i]);
+			if(m_state == error_s) // `offset()` stays on the offending byte
+				break;
+			if(consumed_)
+			{
+				++i;
+				++m_offset;
+			}
+		}
+		return status();
+	}
+
+	Status
+	feed(string_view_t const & data_)
+	{
+		return feed(data_.begin(), data_.length());
+	}
+
+	// marks the end of input; a partially parsed value is an error
+	Status
+	finish()
+	{
+		if(m_state == number_s && !m_top)
+			_finish_number();
+		if(m_state != error_s && (m_top || m_state != value_s))
+			_fail("json::Parser::finish(): unexpected end of input");
+		return status();
+	}
+
+	Status
+	status() const axl_noexcept
+	{
+		if(m_state == error_s)
+			return error;
+		return _size(m_values) > 0 ? done : need_more;
+	}
+
+	// moves the completed top-level values out of the parser
+	Array
+	take() axl_noexcept
+	{
+		Array values_ = axl::move(m_values);
+		m_values = Array();
+		return values_;
+	}
+
+	// true if no partially parsed value is pending
+	bool idle() const axl_noexcept { return !m_top && m_state == value_s; }
+
+	size_t         depth()         const axl_noexcept { return m_depth; }
+	size_t         offset()        const axl_noexcept { return m_offset; }
+	char_t const * error_message() const axl_noexcept { return m_error; }
+
+	void
+	reset()
+	{
+		axl::destruct(this);
+		axl::construct<Parser>(this);
+	}
+
+	bool
+	_fail(char_t const * message_) axl_noexcept
+	{
+		m_state = error_s;
+		m_error = message_;
+		return true;
+	}
+
+	void
+	_push(Variant && container_)
+	{
+		m_top = make_unique<Frame>(axl::move(container_), axl::move(m_top));
+		++m_depth;
+		m_close_ok = true;
+	}
+
+	void
+	_pop()
+	{
+		Variant value_ = axl::move(m_top.ptr()->value);
+		unique_ptr_t<Frame> parent_ = axl::move(m_top.ptr()->parent);
+		m_top = axl::move(parent_);
+		--m_depth;
+		_complete(axl::move(value_));
+	}
+
+	void
+	_complete(Variant && value_)
+	{
+		m_close_ok = false;
+		if(!m_top)
+		{
+			_append(m_values, axl::move(value_));
+			m_state = value_s;
+			return;
+		}
+		auto & frame_ = *m_top.ptr();
+		if(frame_.value.index == Variant::array_i)
+			_append(frame_.value.array, axl::move(value_));
+		else
+		{
+			auto & object_ = frame_.value.object;
+			if(!object_)
+				object_ = Object({ Entry{ axl::move(frame_.key), axl::move(value_) } });
+			else
+				object_.set(_view(frame_.key), axl::move(value_));
+			frame_.key = heap_string_t();
+		}
+		m_state = next_s;
+	}
+
+	void
+	_append_code_point(uint32_t unicode_)
+	{
+		if(unicode_ <= 0x007F)
+			m_builder.append(char_t(unicode_ & 0x7F));
+		else if(unicode_ <= 0x07FF)
+		{
+			m_builder.append(char_t(0xC0 | ((unicode_ >> 6) & 0x1F)));
+			m_builder.append(char_t(0x80 | (unicode_ & 0x3F)));
+		}
+		else if(unicode_ <= 0xFFFF)
+		{
+			m_builder.append(char_t(0xE0 | ((unicode_ >> 12) & 0x0F)));
+			m_builder.append(char_t(0x80 | ((unicode_ >> 6) & 0x3F)));
+			m_builder.append(char_t(0x80 | (unicode_ & 0x3F)));
+		}
+		else if(unicode_ <= 0x10FFFF)
+		{
+			m_builder.append(char_t(0xF0 | ((unicode_ >> 18) & 0x07)));
+			m_builder.append(char_t(0x80 | ((unicode_ >> 12) & 0x3F)));
+			m_builder.append(char_t(0x80 | ((unicode_ >> 6) & 0x3F)));
+			m_builder.append(char_t(0x80 | (unicode_ & 0x3F)));
+		}
+		else // not representable, kept escaped
+		{
+			m_builder.append('\\').append(m_hex_size == 4 ? 'u' : 'U');
+			m_builder.append(&m_hex[0], &m_hex[m_hex_size]);
+		}
+	}
+
+	// an unpaired high surrogate is written out on its own
+	void
+	_flush_surrogate()
+	{
+		if(m_surrogate == 0)
+			return;
+		_append_code_point(m_surrogate);
+		m_surrogate = 0;
+	}
+
+	void
+	_end_string()
+	{
+		if(m_is_key)
+		{
+			m_top.ptr()->key = axl::move(m_builder.string());
+			m_builder.clear();
+			m_state = colon_s;
+		}
+		else
+		{
+			String string_ { _view(m_builder.string()) };
+			m_builder.clear();
+			_complete(Variant(axl::move(string_)));
+		}
+	}
+
+	void
+	_begin_number(char_t ch)
+	{
+		m_number_i  = 0;
+		m_signed    = ch == '-' || ch == '+';
+		m_point     = ch == '.';
+		m_exponent  = false;
+		m_number[m_number_i++] = ch;
+		m_state = number_s;
+	}
+
+	// same grammar as `parse_numeric()`, except that a dangling exponent is rejected
+	bool
+	_number_char(char_t ch)
+	{
+		char_t last_ = m_number[m_number_i - 1];
+		switch(ch)
+		{
+			case '.':
+				if(m_point)
+					return _fail("json::Parser::feed(): multiple decimal point tokens");
+				if(m_exponent)
+					return _fail("json::Parser::feed(): decimal point token after exponent");
+				m_point = true;
+				break;
+			case '-':
+			case '+':
+				if(last_ != 'e' && last_ != 'E')
+					return _fail("json::Parser::feed(): unexpected sign token");
+				break;
+			case 'e':
+			case 'E':
+				if(m_exponent)
+					return _fail("json::Parser::feed(): multiple exponent tokens");
+				if(last_ == '.')
+					return _fail("json::Parser::feed(): exponent token after decimal point token");
+				m_exponent = true;
+				break;
+			default:
+				break;
+		}
+		if(m_number_i >= max_number_size_)
+			return _fail("json::Parser::feed(): numeric token too long");
+		m_number[m_number_i++] = ch;
+		return true;
+	}
+
+	void
+	_finish_number()
+	{
+		char_t last_ = m_number[m_number_i - 1];
+		if((m_number_i == 1 && (m_signed || m_point)) || last_ == '.' || last_ == 'e' || last_ == 'E' || last_ == '-' || last_ == '+')
+		{
+			_fail("json::Parser::feed(): invalid numeric token");
+			return;
+		}
+		m_number[m_number_i] = '\0';
+		if(m_point || m_exponent)
+		{
+			number_t value_ = number_t(atof(m_number));
+			if(m_exponent)
+			{
+				size_t exponent_i = 0;
+				for(; m_number[exponent_i] != 'e' && m_number[exponent_i] != 'E'; ++exponent_i);
+				if(atoi(&m_number[exponent_i + 1]) >= 999)
+					value_ = m_number[0] == '-' ? -inf : inf;
+			}
+			_complete(Variant(value_));
+		}
+		else
+			_complete(Variant(integer_t(atoll(m_number))));
+	}
+
+	// returns false if `ch` was not consumed and has to be dispatched again
+	bool
+	_step(char_t ch)
+	{
+		switch(m_state)
+		{
+			case value_s:
+			{
+				if(axl::is_char_white_space(ch))
+					return true;
+				switch(ch)
+				{
+					case '{':
+						_push(Object());
+						m_state = key_s;
+						return true;
+					case '[':
+						_push(Array());
+						m_state = value_s;
+						return true;
+					case ']':
+						if(!m_close_ok || !m_top || m_top.ptr()->value.index != Variant::array_i)
+							return _fail("json::Parser::feed(): unexpected `]`");
+						_pop();
+						return true;
+					case '"':
+						m_is_key     = false;
+						m_raw_escape = false;
+						m_state      = string_s;
+						return true;
+					case 'n': m_literal = "null";  m_literal_i = 1; m_state = literal_s; return true;
+					case 't': m_literal = "true";  m_literal_i = 1; m_state = literal_s; return true;
+					case 'f': m_literal = "false"; m_literal_i = 1; m_state = literal_s; return true;
+					case '-':
+					case '+':
+					case '.':
+					case '0':
+					case '1':
+					case '2':
+					case '3':
+					case '4':
+					case '5':
+					case '6':
+					case '7':
+					case '8':
+					case '9':
+						_begin_number(ch);
+						return true;
+					default:
+						return _fail("json::Parser::feed(): invalid token");
+				}
+			}
+			case key_s:
+			{
+				if(axl::is_char_white_space(ch))
+					return true;
+				if(ch == '"')
+				{
+					m_is_key     = true;
+					m_raw_escape = false;
+					m_state      = string_s;
+					return true;
+				}
+				if(ch == '}' && m_close_ok)
+				{
+					_pop();
+					return true;
+				}
+				return _fail("json::Parser::feed(): `\"` expected at the start of key, in object");
+			}
+			case colon_s:
+			{
+				if(axl::is_char_white_space(ch))
+					return true;
+				if(ch != ':')
+					return _fail("json::Parser::feed(): `:` expected after key, in object");
+				m_state = value_s;
+				m_close_ok = false;
+				return true;
+			}
+			case next_s:
+			{
+				if(axl::is_char_white_space(ch))
+					return true;
+				bool is_array_ = m_top.ptr()->value.index == Variant::array_i;
+				if(ch == ',')
+				{
+					m_state    = is_array_ ? value_s : key_s;
+					m_close_ok = false;
+					return true;
+				}
+				if(ch == (is_array_ ? ']' : '}'))
+				{
+					_pop();
+					return true;
+				}
+				return _fail(is_array_ ? "json::Parser::feed(): `,` or `]` expected, in array" : "json::Parser::feed(): `,` or `}` expected, in object");
+			}
+			case literal_s:
+			{
+				if(ch != m_literal[m_literal_i])
+					return _fail("json::Parser::feed(): expecting `null|true|false`");
+				if(m_literal[++m_literal_i] == '\0')
+				{
+					switch(m_literal[0])
+					{
+						case 'n': _complete(Variant(null)); break;
+						case 't': _complete(Variant(true)); break;
+						default:  _complete(Variant(false)); break;
+					}
+				}
+				return true;
+			}
+			case number_s:
+			{
+				switch(ch)
+				{
+					case ',':
+					case ']':
+					case '}':
+					case ' ':
+					case '\n':
+					case '\r':
+					case '\t':
+					case '\v':
+					case '\f':
+						_finish_number();
+						return m_state == error_s;
+					case '-':
+					case '+':
+					case '.':
+					case 'e':
+					case 'E':
+					case '0':
+					case '1':
+					case '2':
+					case '3':
+					case '4':
+					case '5':
+					case '6':
+					case '7':
+					case '8':
+					case '9':
+						return _number_char(ch);
+					default:
+						return _fail("json::Parser::feed(): invalid numeric token");
+				}
+			}
+			case string_s:
+			{
+				if(!process_string)
+				{
+					if(ch == '"' && !m_raw_escape)
+						_end_string();
+					else
+					{
+						m_raw_escape = ch == '\\' && !m_raw_escape;
+						m_builder.append(ch);
+					}
+					return true;
+				}
+				if(ch != '\\')
+					_flush_surrogate();
+				if(ch == '"')
+					_end_string();
+				else if(ch == '\\')
+					m_state = escape_s;
+				else
+					m_builder.append(ch);
+				return true;
+			}
+			case escape_s:
+			{
+				m_state = string_s;
+				if(ch != 'u')
+					_flush_surrogate();
+				switch(ch)
+				{
+					case '"':
+					case '\\':
+					case '/': m_builder.append(ch);   return true;
+					case 'b': m_builder.append('\b'); return true;
+					case 'f': m_builder.append('\f'); return true;
+					case 'n': m_builder.append('\n'); return true;
+					case 'r': m_builder.append('\r'); return true;
+					case 't': m_builder.append('\t'); return true;
+					case 'u':
+					case 'U':
+						if(ch == 'u' ? decode_utf8 : decode_utf8_ext)
+						{
+							m_hex_i    = 0;
+							m_hex_size = ch == 'u' ? 4 : 6;
+							m_state    = unicode_s;
+						}
+						else
+							m_builder.append('\\').append(ch);
+						return true;
+					default:
+						return _fail("json::Parser::feed(): invalid escaped string token");
+				}
+			}
+			case unicode_s:
+			{
+				if(!((ch >= '0' && ch <= '9') || (ch >= 'a' && ch <= 'f') || (ch >= 'A' && ch <= 'F')))
+					return _fail("json::Parser::feed(): invalid unicode escape");
+				m_hex[m_hex_i++] = ch;
+				if(m_hex_i == m_hex_size)
+				{
+					uint32_t unicode_ = 0;
+					for(size_t i = 0; i < m_hex_size; ++i)
+						unicode_ = (unicode_ << 4) | hex_value(m_hex[i]);
+					if(m_hex_size == 4 && m_surrogate != 0 && unicode_ >= 0xDC00 && unicode_ <= 0xDFFF)
+					{
+						unicode_ = 0x10000 + ((m_surrogate - 0xD800) << 10) + (unicode_ - 0xDC00);
+						m_surrogate = 0;
+					}
+					_flush_surrogate();
+					if(m_hex_size == 4 && unicode_ >= 0xD800 && unicode_ <= 0xDBFF)
+						m_surrogate = unicode_;
+					else
+						_append_code_point(unicode_);
+					m_state = string_s;
+				}
+				return true;
+			}
+			case error_s:
+			default:
+				return true;
+		}
+	}
+
+};
+
 } // namespace json
 
 namespace stream {
@@ -2182,23 +3540,12 @@ hash(axl::json::string_view_t const & string_)
 	return axl::hash_string(string_.begin());
 }
 
-static hash_t 
+// content hash spread over the full hash range. composite values answer from the hash cached
+// in the node, so a repeated insert or lookup costs O(1); their non-const accessors reset it.
+static inline hash_t 
 hash(axl::json::Variant const & var)
 {
-	constexpr hash_t partition_size_      = (axl::json::hash_table_size_ - 4) / 4;
-	constexpr hash_t half_partition_size_ = partition_size_ / 2;
-	switch(var.index)
-	{
-		case var.null_i:    return 1;
-		case var.boolean_i: return (var.boolean.value() + 2);
-		case var.integer_i: return ((axl::hash(var.integer.value()) % partition_size_) + 4);
-		case var.number_i:  return ((axl::hash(*reinterpret_cast<uint64_t const *>(&var.number.value())) % partition_size_) + partition_size_);
-		case var.string_i:  return (((var.string ? axl::hash(var.string.value()) : 0) % partition_size_) + partition_size_ * 2);
-		case var.array_i:   return ((axl::hash(&var) % half_partition_size_) + partition_size_ * 3);
-		case var.object_i:  return ((axl::hash(&var) % half_partition_size_) + partition_size_ * 3 + half_partition_size_);
-		case var.invalid_i:
-		default: return 0;
-	}
+	return axl::json::content_hash(var);
 }
 
 } // namespace axl
@@ -0,0 +1,209 @@
+#include <pptest>
+#include <colored_printer>
+#include <ds/event_loop>
+#include <sys/socket.h>
+#include <atomic>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+static constexpr int64_t milliseconds = 1000000;
+
+// a non-blocking socket pair whose first end has the smallest send buffer the
+// kernel allows, so large writes back up
+struct SocketPair
+{
+	int fds[2] = { -1, -1 };
+
+	SocketPair() noexcept
+	{
+		if(::socketpair(AF_UNIX, SOCK_STREAM, 0, fds) != 0)
+			return;
+		int const send_buffer_ = 4096;
+		::setsockopt(fds[0], SOL_SOCKET, SO_SNDBUF, &send_buffer_, sizeof(send_buffer_));
+		ds::EventLoop::set_nonblocking(fds[0]);
+		ds::EventLoop::set_nonblocking(fds[1]);
+	}
+
+	~SocketPair() noexcept
+	{
+		for(auto fd_ : fds)
+			if(fd_ >= 0)
+				::close(fd_);
+	}
+
+	explicit operator bool() const noexcept { return fds[0] >= 0 && fds[1] >= 0; }
+};
+
+Test(event_loop_test)
+{
+	TestInit(event_loop_test);
+
+	// client sends 1 MiB, far more than the socket buffers hold, the server reads
+	// it to the end of the stream and answers with the byte count
+	Testcase(socketpair_round_trip_with_write_backlog)
+	{
+		static constexpr size_t size_ = size_t(1) << 20;
+		ds::EventLoop loop_;
+		SocketPair    pair_;
+		AssertTrue(bool(loop_));
+		AssertTrue(bool(pair_));
+		int const client_ = pair_.fds[0];
+		int const server_ = pair_.fds[1];
+
+		std::vector<unsigned char> sent_(size_);
+		std::vector<unsigned char> received_(size_ + 1); // a read of 0 is always the end of the stream
+		for(size_t i = 0; i < size_; ++i)
+			sent_[i] = (unsigned char)(i * 7 + i / 251);
+
+		ssize_t  written_       = 0;
+		size_t   received_size_ = 0;
+		bool     end_of_stream_ = false;
+		uint64_t reply_         = 0;
+		uint64_t answer_        = 0;
+		ssize_t  answer_size_   = 0;
+
+		AssertTrue(loop_.async_write(client_, sent_.data(), size_, [&](ssize_t count_)
+		{
+			written_ = count_;
+			::shutdown(client_, SHUT_WR);
+			loop_.async_read(client_, &answer_, sizeof(answer_), [&](ssize_t read_) { answer_size_ = read_; });
+		}));
+		AssertTrue(loop_.spawn([&]()
+		{
+			for(;;)
+			{
+				auto const read_ = ::read(server_, received_.data() + received_size_, received_.size() - received_size_);
+				if(read_ > 0)
+				{
+					received_size_ += size_t(read_);
+					continue;
+				}
+				if(read_ < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+					return ds::IoAwait::readable(server_);
+				end_of_stream_ = read_ == 0;
+				reply_         = uint64_t(received_size_);
+				loop_.async_write(server_, &reply_, sizeof(reply_), [](ssize_t) {});
+				return ds::IoAwait::done();
+			}
+		}));
+
+		// the first turn cannot get the whole message through the socket buffers
+		loop_.run_once(0);
+		ExpectEQ(written_, 0);
+		ExpectGT(loop_.tasks(), size_t(0));
+
+		loop_.run();
+		ExpectEQ(loop_.tasks(), size_t(0));
+		ExpectEQ(written_, ssize_t(size_));
+		ExpectTrue(end_of_stream_);
+		AssertEQ(received_size_, size_);
+		ExpectEQ(std::memcmp(sent_.data(), received_.data(), size_), 0);
+		ExpectEQ(answer_size_, ssize_t(sizeof(answer_)));
+		ExpectEQ(answer_, uint64_t(size_));
+		loop_.forget(client_);
+		loop_.forget(server_);
+	} TestcaseEnd(socketpair_round_trip_with_write_backlog);
+
+	Testcase(timers_fire_in_deadline_order)
+	{
+		ds::EventLoop loop_;
+		AssertTrue(bool(loop_));
+		std::vector<int> order_;
+		auto const start_ = ds::EventLoop::now();
+		AssertTrue(bool(loop_.call_after(30 * milliseconds, [&]() { order_.push_back(30); })));
+		AssertTrue(bool(loop_.call_after(10 * milliseconds, [&]() { order_.push_back(10); })));
+		AssertTrue(bool(loop_.call_after(20 * milliseconds, [&]() { order_.push_back(20); })));
+		AssertTrue(bool(loop_.call_after(0,                 [&]() { order_.push_back(0); })));
+		ExpectEQ(loop_.tasks(), size_t(4));
+		loop_.run();
+		ExpectGE(ds::EventLoop::now() - start_, 30 * milliseconds);
+		AssertEQ(order_.size(), size_t(4));
+		ExpectEQ(order_[0], 0);
+		ExpectEQ(order_[1], 10);
+		ExpectEQ(order_[2], 20);
+		ExpectEQ(order_[3], 30);
+	} TestcaseEnd(timers_fire_in_deadline_order);
+
+	Testcase(cancel_drops_pending_timers_only)
+	{
+		ds::EventLoop loop_;
+		AssertTrue(bool(loop_));
+		int  fired_   = 0;
+		auto kept_    = loop_.call_after(5 * milliseconds, [&]() { fired_ += 1; });
+		auto dropped_ = loop_.call_after(1 * milliseconds, [&]() { fired_ += 10; });
+		auto late_    = loop_.call_after(50 * milliseconds, [&]() { fired_ += 100; });
+		AssertTrue(bool(kept_));
+		AssertTrue(bool(dropped_));
+		AssertTrue(bool(late_));
+		ExpectEQ(loop_.tasks(), size_t(3));
+
+		ExpectTrue(loop_.cancel(dropped_));
+		ExpectFalse(bool(dropped_));
+		ExpectFalse(loop_.cancel(dropped_));
+		ExpectEQ(loop_.tasks(), size_t(2));
+
+		// a timer cancelled by another one before its deadline
+		auto const start_ = ds::EventLoop::now();
+		AssertTrue(bool(loop_.call_after(2 * milliseconds, [&]() { loop_.cancel(late_); })));
+		loop_.run();
+		ExpectLT(ds::EventLoop::now() - start_, 50 * milliseconds);
+		ExpectEQ(fired_, 1);
+		ExpectFalse(bool(late_));
+
+		// a timer that has fired can no longer be cancelled
+		ExpectTrue(bool(kept_));
+		ExpectFalse(loop_.cancel(kept_));
+		ExpectEQ(loop_.tasks(), size_t(0));
+	} TestcaseEnd(cancel_drops_pending_timers_only);
+
+	Testcase(post_wakes_a_sleeping_loop)
+	{
+		ds::EventLoop loop_;
+		AssertTrue(bool(loop_));
+		// keeps the loop asleep in epoll_wait until the post arrives
+		auto             guard_     = loop_.call_after(10000 * milliseconds, []() {});
+		bool             ran_       = false;
+		std::thread::id  ran_on_    {};
+		std::atomic<int> posted_    { 0 };
+		AssertTrue(bool(guard_));
+
+		auto const start_ = ds::EventLoop::now();
+		std::thread poster_([&]()
+		{
+			std::this_thread::sleep_for(std::chrono::milliseconds(50));
+			posted_.store(loop_.post([&]()
+			{
+				ran_    = true;
+				ran_on_ = std::this_thread::get_id();
+				loop_.cancel(guard_);
+			}) ? 1 : -1);
+		});
+		loop_.run();
+		auto const elapsed_ = ds::EventLoop::now() - start_;
+		poster_.join();
+
+		ExpectEQ(posted_.load(), 1);
+		ExpectTrue(ran_);
+		ExpectTrue(ran_on_ == std::this_thread::get_id());
+		ExpectGE(elapsed_, 50 * milliseconds);
+		ExpectLT(elapsed_, 5000 * milliseconds);
+		ExpectEQ(loop_.tasks(), size_t(0));
+	} TestcaseEnd(post_wakes_a_sleeping_loop);
+
+};
+
+TestRegistry(event_loop_test)
+{
+	Register(socketpair_round_trip_with_write_backlog)
+	Register(timers_fire_in_deadline_order)
+	Register(cancel_drops_pending_timers_only)
+	Register(post_wakes_a_sleeping_loop)
+};
+
+template <class C> using reporter_t = pptest::colored_printer<C>;
+
+int main()
+{
+	return event_loop_test().run_all(reporter_t<event_loop_test>(pptest::normal));
+}
@@ -0,0 +1,373 @@
+#include <pptest>
+#include <colored_printer>
+#include <axl/resource/json.hpp>
+#include <cstring>
+
+namespace json = axl::json;
+
+// the first top-level value of text_, invalid if it does not parse
+static json::Variant
+parse_text(char const * text_)
+{
+	json::Parser parser_;
+	parser_.feed(text_, strlen(text_));
+	if(parser_.finish() != json::Parser::done)
+		return json::Variant();
+	auto values_ = parser_.take();
+	return axl::move(*values_.elements().begin().ptr());
+}
+
+// the same text through the one-shot stream parser
+struct TextInput : public axl::stream::Input
+{
+	char const * text;
+	size_t       length;
+	size_t       i = 0;
+
+	TextInput(char const * text_)
+		: text   { text_ }
+		, length { strlen(text_) }
+	{}
+
+	size_t
+	read(void * data_, size_t size_, size_t count_)
+	{
+		size_t n = (length - i) / size_;
+		if(n > count_)
+			n = count_;
+		memcpy(data_, &text[i], n * size_);
+		i += n * size_;
+		return n;
+	}
+
+	bool is_at_end() const { return i >= length; }
+};
+
+static json::Variant
+parse_one_shot(char const * text_)
+{
+	TextInput input_ { text_ };
+	json::Variant value_;
+	json::parse(input_, value_);
+	return value_;
+}
+
+// text_ fed in the given fragment sizes, the last one taking the rest
+static json::Variant
+parse_fragments(char const * text_, size_t first_, size_t size_)
+{
+	size_t const length_ = strlen(text_);
+	json::Parser parser_;
+	size_t i = first_ < length_ ? first_ : length_;
+	parser_.feed(text_, i);
+	for(; i < length_; i += size_)
+		parser_.feed(text_ + i, (length_ - i) < size_ ? (length_ - i) : size_);
+	if(parser_.finish() != json::Parser::done)
+		return json::Variant();
+	auto values_ = parser_.take();
+	if(values_.elements().size() != 1)
+		return json::Variant();
+	return axl::move(*values_.elements().begin().ptr());
+}
+
+// the offset the parser stops at, or size_t(-1) if text_ parses
+static size_t
+error_offset(char const * text_)
+{
+	json::Parser parser_;
+	if(parser_.feed(text_, strlen(text_)) != json::Parser::error && parser_.finish() != json::Parser::error)
+		return size_t(-1);
+	return parser_.offset();
+}
+
+static size_t
+operation_count(json::Array const & operations_)
+{
+	return !operations_ ? 0 : operations_.elements().size();
+}
+
+// containers at the top, which the one-shot parser needs to know where a number ends
+static char const * const documents[] =
+{
+	  R"(["plain","q\"uote","back\\slash","\/\b\f\n\r\t",""])"
+	, R"(["\u0041\u00e9\u6771\u4EAC","\ud83d\ude00","x\uD834\uDD1Ey"])"
+	, R"([0,-1,+2,-0,12345678901,1.5,-0.25,.5,3e2,-4E-2,5e+1,6.5e-3,9e999,-9e999])"
+	, R"([true,false,null,[],{},[[]],{"a":{}}])"
+	, R"( { "k" : [ 1 , "v" , { "n" : null } ] , "t" : true , "u" : "\u00fc" } )"
+	, R"({"a":{"b":[1,2,{"c":"d\u0020e"}],"f":-1.5e-1},"g":[false,"h\"i"]})"
+};
+
+struct DiffCase
+{
+	char const * source;
+	char const * target;
+};
+
+// pairs a patch has to get from the first to the second document. targets hold no
+// `null` members, which a merge patch cannot express.
+static DiffCase const diff_cases[] =
+{
+	{ R"({"a":1,"b":[1,2,3,4],"c":{"d":"x"}})",    R"({"a":1,"b":[1,9,3,4,5],"c":{"d":"y","e/~":true}})" },
+	{ R"([1,2,3,4,5])",                             R"([1,4,5])" },
+	{ R"([1,2,3])",                                 R"([0,1,2,3])" },
+	{ R"({"x":[{"k":1},{"k":2}]})",                 R"({"y":2,"x":[{"k":1},{"k":3}]})" },
+	{ R"({"a":{"b":{"c":[1,2,{"d":1}]}},"e":1})",   R"({"a":{"b":{"c":[1,2,{"d":2}]}}})" },
+	{ R"({"a":[1,2]})",                             R"({"a":{"0":1}})" },
+	{ R"({"a":1.5,"b":"s"})",                       R"({"a":2,"b":"t","c":[]})" },
+	{ R"({})",                                      R"({"a":{"b":[true,false]}})" },
+};
+
+Test(json_test)
+{
+	TestInit(json_test);
+
+	// a split anywhere, even inside a token, gives what the one-shot parser gives
+	Testcase(fragment_splits_match_one_shot)
+	{
+		for(auto text_ : documents)
+		{
+			auto const expected_ = parse_one_shot(text_);
+			AssertTrue(bool(expected_));
+			ExpectTrue(json::equal(parse_text(text_), expected_));
+			ExpectTrue(json::equal(parse_fragments(text_, 0, 1), expected_));
+			for(size_t first_ = 0, length_ = strlen(text_); first_ <= length_; ++first_)
+				AssertTrue(json::equal(parse_fragments(text_, first_, length_), expected_));
+			for(size_t size_ = 2; size_ < 8; ++size_)
+				ExpectTrue(json::equal(parse_fragments(text_, size_, size_), expected_));
+		}
+	} TestcaseEnd(fragment_splits_match_one_shot);
+
+	Testcase(escapes_and_surrogate_pairs)
+	{
+		auto const strings_ = parse_fragments(R"(["a\"b\\c\/d\b\f\n\r\t","\u00e9\u6771","\ud83d\ude00","\ud83d","\ud83dx","\ude00\ud83d\u0041"])", 0, 1);
+		AssertTrue(bool(strings_));
+		AssertEQ(strings_.array.elements().size(), size_t(6));
+		ExpectTrue(strings_.array[0] == json::Variant("a\"b\\c/d\b\f\n\r\t"));
+		ExpectTrue(strings_.array[1] == json::Variant("\xC3\xA9\xE6\x9D\xB1"));
+		ExpectTrue(strings_.array[2] == json::Variant("\xF0\x9F\x98\x80"));
+		// an unpaired surrogate is kept as its own three bytes
+		ExpectTrue(strings_.array[3] == json::Variant("\xED\xA0\xBD"));
+		ExpectTrue(strings_.array[4] == json::Variant("\xED\xA0\xBDx"));
+		ExpectTrue(strings_.array[5] == json::Variant("\xED\xB8\x80\xED\xA0\xBD" "A"));
+		ExpectTrue(json::equal(strings_, parse_one_shot(R"(["a\"b\\c\/d\b\f\n\r\t","\u00e9\u6771","\ud83d\ude00","\ud83d","\ud83dx","\ude00\ud83d\u0041"])")));
+	} TestcaseEnd(escapes_and_surrogate_pairs);
+
+	Testcase(numbers_and_literals)
+	{
+		auto const values_ = parse_text("[0,-12,+3,1.5,-2.5e3,1E-2,2e+1,9e999,true,false,null]");
+		AssertTrue(bool(values_));
+		AssertEQ(values_.array.elements().size(), size_t(11));
+		ExpectTrue(values_.array[0] == json::Variant(json::integer_t(0)));
+		ExpectTrue(values_.array[1] == json::Variant(json::integer_t(-12)));
+		ExpectTrue(values_.array[2] == json::Variant(json::integer_t(3)));
+		ExpectTrue(values_.array[3] == json::Variant(1.5));
+		ExpectTrue(values_.array[4] == json::Variant(-2500.0));
+		ExpectTrue(values_.array[5] == json::Variant(0.01));
+		ExpectTrue(values_.array[6] == json::Variant(20.0));
+		ExpectTrue(values_.array[7] == json::Variant(json::inf));
+		ExpectTrue(values_.array[8] == json::Variant(true));
+		ExpectTrue(values_.array[9] == json::Variant(false));
+		ExpectTrue(values_.array[10] == json::Variant(json::null));
+		// a top-level number is complete at the end of input
+		ExpectTrue(parse_text("-7") == json::Variant(json::integer_t(-7)));
+		ExpectTrue(parse_text(" 2.5e1 ") == json::Variant(25.0));
+	} TestcaseEnd(numbers_and_literals);
+
+	// offset() is the offending byte, or the end of input for an unfinished value
+	Testcase(error_offsets)
+	{
+		ExpectEQ(error_offset("[1,]"),              size_t(3));
+		ExpectEQ(error_offset("[1 2]"),             size_t(3));
+		ExpectEQ(error_offset(R"({"a" 1})"),        size_t(5));
+		ExpectEQ(error_offset(R"({"a":1,})"),       size_t(7));
+		ExpectEQ(error_offset("[tru e]"),           size_t(4));
+		ExpectEQ(error_offset("[1.2.3]"),           size_t(4));
+		ExpectEQ(error_offset("[1e2e3]"),           size_t(4));
+		ExpectEQ(error_offset("[1-2]"),             size_t(2));
+		ExpectEQ(error_offset("[1x]"),              size_t(2));
+		ExpectEQ(error_offset(R"(["\q"])"),         size_t(3));
+		ExpectEQ(error_offset(R"(["\u12x4"])"),     size_t(6));
+		ExpectEQ(error_offset("  @"),               size_t(2));
+		ExpectEQ(error_offset("[1,[2,3]"),          size_t(8));
+		ExpectEQ(error_offset(R"({"a":"b)"),        size_t(7));
+		ExpectEQ(error_offset("[1, 2] [3]"),        size_t(-1));
+
+		// the offset counts across fragments, and input after an error is ignored
+		json::Parser parser_;
+		ExpectEQ(parser_.feed("[1,", 3), json::Parser::need_more);
+		ExpectEQ(parser_.feed("]", 1), json::Parser::error);
+		ExpectEQ(parser_.offset(), size_t(3));
+		ExpectTrue(parser_.error_message() != nullptr);
+		ExpectEQ(parser_.feed("[]", 2), json::Parser::error);
+		ExpectEQ(parser_.offset(), size_t(3));
+		parser_.reset();
+		ExpectEQ(parser_.feed("[]", 2), json::Parser::done);
+		ExpectEQ(parser_.offset(), size_t(2));
+	} TestcaseEnd(error_offsets);
+
+	Testcase(multiple_top_level_values)
+	{
+		char const * const text_ = R"(1 "two" [3] {"four":4} true null -5.5)";
+		json::Variant const expected_[] =
+		{
+			  json::Variant(json::integer_t(1))
+			, json::Variant("two")
+			, parse_text("[3]")
+			, parse_text(R"({"four":4})")
+			, json::Variant(true)
+			, json::Variant(json::null)
+			, json::Variant(-5.5)
+		};
+		size_t const length_ = strlen(text_);
+		for(size_t first_ = 0; first_ <= length_; ++first_)
+		{
+			json::Parser parser_;
+			parser_.feed(text_, first_);
+			auto const head_ = parser_.take();
+			parser_.feed(text_ + first_, length_ - first_);
+			AssertEQ(parser_.finish(), json::Parser::done);
+			ExpectTrue(parser_.idle());
+			auto const tail_ = parser_.take();
+			size_t i = 0;
+			for(auto const * values_ : { &head_, &tail_ })
+			{
+				if(!*values_)
+					continue;
+				for(auto it = values_->elements().begin(); it; ++it, ++i)
+					AssertTrue(i < 7 && json::equal(*it.ptr(), expected_[i]));
+			}
+			ExpectEQ(i, size_t(7));
+		}
+
+		// a number waits for its delimiter before it counts as a value
+		json::Parser parser_;
+		ExpectEQ(parser_.feed("12", 2), json::Parser::need_more);
+		ExpectFalse(parser_.idle());
+		ExpectEQ(parser_.feed(" 3", 2), json::Parser::done);
+		ExpectEQ(parser_.take().elements().size(), size_t(1));
+		ExpectEQ(parser_.finish(), json::Parser::done);
+		ExpectTrue(parser_.take()[0] == json::Variant(json::integer_t(3)));
+	} TestcaseEnd(multiple_top_level_values);
+
+	Testcase(equal_content_hashes_equal)
+	{
+		auto const a_ = parse_text(R"({"a":1,"b":[1,2,{"c":null}],"d":-0.0})");
+		auto const b_ = parse_text(R"({"d":0.0,"b":[1,2,{"c":null}],"a":1})");
+		auto const c_ = parse_text(R"({"a":1,"b":[1,2,{"c":false}],"d":0.0})");
+		AssertTrue(bool(a_) && bool(b_) && bool(c_));
+		ExpectEQ(json::content_hash(a_), json::content_hash(b_));
+		ExpectTrue(json::equal(a_, b_));
+		ExpectTrue(json::content_hash(a_) != json::content_hash(c_));
+		ExpectFalse(json::equal(a_, c_));
+		ExpectTrue(json::content_hash(parse_text("[1,2]")) != json::content_hash(parse_text("[2,1]")));
+	} TestcaseEnd(equal_content_hashes_equal);
+
+	// a write below the root resets every hash on the way down and no other
+	Testcase(nested_mutation_resets_cached_hashes)
+	{
+		auto doc_ = parse_text(R"({"a":{"b":{"c":1}},"s":[1,2,3]})");
+		AssertTrue(bool(doc_));
+		auto const hash_ = json::content_hash(doc_);
+		ExpectEQ(doc_.object.m_hash, hash_);
+
+		doc_["a"]["b"]["c"] = json::Variant(2);
+		ExpectEQ(doc_.object.m_hash, axl::hash_t(0));
+		ExpectEQ(doc_["a"].object.m_hash, axl::hash_t(0));
+		ExpectTrue(doc_["s"].array.m_hash != 0);
+
+		auto const expected_ = parse_text(R"({"a":{"b":{"c":2}},"s":[1,2,3]})");
+		ExpectEQ(json::content_hash(doc_), json::content_hash(expected_));
+		ExpectTrue(json::content_hash(doc_) != hash_);
+		ExpectTrue(json::equal(doc_, expected_));
+
+		// a copy carries the cache, and a change to it leaves the original alone
+		auto copy_ = doc_;
+		ExpectEQ(copy_.object.m_hash, doc_.object.m_hash);
+		copy_["s"].array.insert(json::Variant(4));
+		ExpectTrue(json::content_hash(copy_) != json::content_hash(doc_));
+		ExpectEQ(json::content_hash(doc_), json::content_hash(expected_));
+	} TestcaseEnd(nested_mutation_resets_cached_hashes);
+
+	// axl::hash keys hash tables on Variants with the cached content hash
+	Testcase(variant_key_hash_is_cached)
+	{
+		auto key_ = parse_text(R"([{"id":1,"tags":["a","b"]},[1,2,3]])");
+		AssertTrue(bool(key_));
+		ExpectEQ(key_.array.m_hash, axl::hash_t(0));
+		auto const hash_ = axl::hash(key_);
+		ExpectEQ(hash_, json::content_hash(key_));
+		ExpectEQ(key_.array.m_hash, hash_);
+		ExpectEQ(axl::hash(json::Variant(key_)), hash_);
+		ExpectTrue(key_ == json::Variant(key_));
+
+		key_.array.insert(json::Variant(4));
+		ExpectEQ(key_.array.m_hash, axl::hash_t(0));
+		ExpectTrue(axl::hash(key_) != hash_);
+		ExpectEQ(axl::hash(key_), axl::hash(parse_text(R"([{"tags":["a","b"],"id":1},[1,2,3],4])")));
+	} TestcaseEnd(variant_key_hash_is_cached);
+
+	Testcase(diff_patch_round_trip)
+	{
+		for(auto const & case_ : diff_cases)
+		{
+			auto       source_ = parse_text(case_.source);
+			auto const target_ = parse_text(case_.target);
+			AssertTrue(bool(source_) && bool(target_));
+			auto const operations_ = json::diff(source_, target_);
+			ExpectTrue(operation_count(operations_) > 0);
+			json::patch(source_, operations_);
+			ExpectTrue(json::equal(source_, target_));
+			ExpectEQ(json::content_hash(source_), json::content_hash(target_));
+			ExpectEQ(operation_count(json::diff(source_, target_)), size_t(0));
+		}
+	} TestcaseEnd(diff_patch_round_trip);
+
+	// only the changed member shows up, the equal siblings are skipped
+	Testcase(diff_skips_identical_subtrees)
+	{
+		auto const source_ = parse_text(R"({"big":[[1,2,3],[4,5,6],{"x":"y"}],"n":1})");
+		auto const target_ = parse_text(R"({"big":[[1,2,3],[4,5,6],{"x":"y"}],"n":2})");
+		auto const operations_ = json::diff(source_, target_);
+		AssertEQ(operation_count(operations_), size_t(1));
+		auto const & operation_ = *operations_.elements().begin().ptr();
+		ExpectTrue(operation_["op"] == json::Variant("replace"));
+		ExpectTrue(operation_["path"] == json::Variant("/n"));
+		ExpectEQ(operation_count(json::diff(source_, json::Variant(source_))), size_t(0));
+	} TestcaseEnd(diff_skips_identical_subtrees);
+
+	Testcase(merge_patch_round_trip)
+	{
+		for(auto const & case_ : diff_cases)
+		{
+			auto       source_ = parse_text(case_.source);
+			auto const target_ = parse_text(case_.target);
+			AssertTrue(bool(source_) && bool(target_));
+			auto const patch_ = json::merge_diff(source_, target_);
+			json::merge_patch(source_, patch_);
+			ExpectTrue(json::equal(source_, target_));
+		}
+	} TestcaseEnd(merge_patch_round_trip);
+
+};
+
+TestRegistry(json_test)
+{
+	Register(fragment_splits_match_one_shot)
+	Register(escapes_and_surrogate_pairs)
+	Register(numbers_and_literals)
+	Register(error_offsets)
+	Register(multiple_top_level_values)
+	Register(equal_content_hashes_equal)
+	Register(nested_mutation_resets_cached_hashes)
+	Register(variant_key_hash_is_cached)
+	Register(diff_patch_round_trip)
+	Register(diff_skips_identical_subtrees)
+	Register(merge_patch_round_trip)
+};
+
+template <class C> using reporter_t = pptest::colored_printer<C>;
+
+int main()
+{
+	return json_test().run_all(reporter_t<json_test>(pptest::normal));
+}
@@ -0,0 +1,143 @@
+#include <pptest>
+#include <colored_printer>
+#include <ds/sort>
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <vector>
+
+// NaNs break the strict weak order the partition loop relies on, so they only go
+// to ranges the small kernel or the insertion sort below it finish
+#ifdef DS_SORT_AVX2
+static constexpr size_t float_small  = 64;
+static constexpr size_t double_small = 16;
+#else
+static constexpr size_t float_small  = 23;
+static constexpr size_t double_small = 23;
+#endif
+
+template <typename T, typename B>
+static std::vector<B>
+sorted_bits(std::vector<T> const & values_)
+{
+	std::vector<B> bits_(values_.size());
+	for(size_t i = 0; i < values_.size(); ++i)
+		std::memcpy(&bits_[i], &values_[i], sizeof(T));
+	std::sort(bits_.begin(), bits_.end());
+	return bits_;
+}
+
+// values_ sorted with ds::pdqsort hold the same bit patterns as before
+template <typename T, typename B>
+static bool
+is_permutation_of(std::vector<T> const & sorted_, std::vector<T> const & values_)
+{
+	return sorted_bits<T,B>(sorted_) == sorted_bits<T,B>(values_);
+}
+
+// ascending apart from NaNs, which compare false with everything
+template <typename T>
+static bool
+is_sorted_numbers(std::vector<T> const & values_)
+{
+	T last_ = -std::numeric_limits<T>::infinity();
+	for(auto value_ : values_)
+	{
+		if(std::isnan(value_))
+			continue;
+		if(value_ < last_)
+			return false;
+		last_ = value_;
+	}
+	return true;
+}
+
+// signed zeros, NaNs and duplicates among n keys
+template <typename T>
+static std::vector<T>
+make_keys(size_t n, bool nans_)
+{
+	std::vector<T> values_;
+	uint64_t       state_ = 0x9e3779b97f4a7c15ULL + n;
+	for(size_t i = 0; i < n; ++i)
+	{
+		state_ ^= state_ << 13;
+		state_ ^= state_ >> 7;
+		state_ ^= state_ << 17;
+		switch(state_ % 8)
+		{
+			case 0:  values_.push_back(T(0.0));  break;
+			case 1:  values_.push_back(T(-0.0)); break;
+			case 2:  values_.push_back(nans_ ? std::numeric_limits<T>::quiet_NaN() : T(1.5)); break;
+			case 3:  values_.push_back(-std::numeric_limits<T>::infinity()); break;
+			default: values_.push_back(T(int64_t(state_ % 64) - 32) / T(4));
+		}
+	}
+	if(nans_ && n > 1)
+		values_[n / 2] = -std::numeric_limits<T>::quiet_NaN();
+	return values_;
+}
+
+Test(sort_test)
+{
+	TestInit(sort_test);
+
+	// every size the small kernel takes, padded or full
+	Testcase(float_signed_zeros_and_nans_stay_a_permutation)
+	{
+		for(size_t n = 0; n <= float_small; ++n)
+		{
+			auto const values_ = make_keys<float>(n, true);
+			auto       sorted_ = values_;
+			ds::pdqsort(sorted_.data(), sorted_.data() + sorted_.size());
+			AssertTrue(is_permutation_of<float,uint32_t>(sorted_, values_));
+		}
+	} TestcaseEnd(float_signed_zeros_and_nans_stay_a_permutation);
+
+	Testcase(double_signed_zeros_and_nans_stay_a_permutation)
+	{
+		for(size_t n = 0; n <= double_small; ++n)
+		{
+			auto const values_ = make_keys<double>(n, true);
+			auto       sorted_ = values_;
+			ds::pdqsort(sorted_.data(), sorted_.data() + sorted_.size());
+			AssertTrue(is_permutation_of<double,uint64_t>(sorted_, values_));
+		}
+	} TestcaseEnd(double_signed_zeros_and_nans_stay_a_permutation);
+
+	// without NaNs the order is defined, through the partition loop as well
+	Testcase(signed_zeros_sort_in_large_ranges)
+	{
+		for(size_t n : { size_t(40), size_t(1000), size_t(100000) })
+		{
+			auto const floats_ = make_keys<float>(n, false);
+			auto       sorted_floats_ = floats_;
+			ds::pdqsort(sorted_floats_.data(), sorted_floats_.data() + sorted_floats_.size());
+			ExpectTrue(is_permutation_of<float,uint32_t>(sorted_floats_, floats_));
+			ExpectTrue(is_sorted_numbers(sorted_floats_));
+
+			auto const doubles_ = make_keys<double>(n, false);
+			auto       sorted_doubles_ = doubles_;
+			ds::pdqsort(sorted_doubles_.data(), sorted_doubles_.data() + sorted_doubles_.size());
+			ExpectTrue(is_permutation_of<double,uint64_t>(sorted_doubles_, doubles_));
+			ExpectTrue(is_sorted_numbers(sorted_doubles_));
+		}
+	} TestcaseEnd(signed_zeros_sort_in_large_ranges);
+
+};
+
+TestRegistry(sort_test)
+{
+	Register(float_signed_zeros_and_nans_stay_a_permutation)
+	Register(double_signed_zeros_and_nans_stay_a_permutation)
+	Register(signed_zeros_sort_in_large_ranges)
+};
+
+template <class C> using reporter_t = pptest::colored_printer<C>;
+
+int main()
+{
+	return sort_test().run_all(reporter_t<sort_test>(pptest::normal));
+}